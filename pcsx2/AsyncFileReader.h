@@ -53,6 +53,9 @@ public:
 	virtual void SetBlockSize(uint bytes) {}
 	virtual void SetDataOffset(int bytes) {}
 
+	// Hint that sectors from this one onward will be requested soon (CDVD seek target)
+	virtual void Prefetch(uint sector) {}
+
 	uint GetBlockSize() const { return m_blocksize; }
 
 	const wxString& GetFilename() const
@@ -76,6 +79,24 @@ class FlatFileReader : public AsyncFileReader
 #elif defined(__linux__)
 	int m_fd; // FIXME don't know if overlap as an equivalent on linux
 	io_context_t m_aio_context;
+
+	// Optional read-only mapping of a window of the image, moved when a read
+	// falls outside of it. Reads are served with a memcpy instead of an aio
+	// submit/complete pair per request.
+	bool m_map_enabled;
+	s64 m_file_size;
+	u8* m_mapping;
+	s64 m_mapping_offset; // file offset of the first mapped byte
+	s64 m_mapping_size;
+	s64 m_advised_start; // file range of the last POSIX_FADV_WILLNEED
+	s64 m_advised_end;
+	bool m_mapped_pending; // BeginRead was served from the mapping
+	int m_mapped_result;
+
+	bool MapFile();
+	bool MapWindow(s64 offset, s64 bytes);
+	void UnmapFile();
+	void AdviseReadAhead(s64 offset, bool force);
 #elif defined(__POSIX__)
 	int m_fd; // TODO OSX don't know if overlap as an equivalent on OSX
 	struct aiocb m_aiocb;
@@ -102,6 +123,10 @@ public:
 
 	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
 	virtual void SetDataOffset(int bytes) { m_dataoffset = bytes; }
+
+#if defined(__linux__)
+	virtual void Prefetch(uint sector);
+#endif
 };
 
 class MultipartFileReader : public AsyncFileReader
@@ -139,6 +164,8 @@ public:
 
 	virtual void SetBlockSize(uint bytes);
 
+	virtual void Prefetch(uint sector);
+
 	static AsyncFileReader* DetectMultipart(AsyncFileReader* reader);
 };
 
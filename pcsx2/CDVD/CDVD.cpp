@@ -915,6 +915,7 @@ __fi void cdvdReadInterrupt()
 static uint cdvdStartSeek( uint newsector, CDVD_MODE_TYPE mode )
 {
 	cdvd.SeekToSector = newsector;
+	DoCDVDprefetch(newsector);
 
 	uint delta = abs( (s32)(cdvd.SeekToSector - cdvd.Sector) );
 	uint seektime;
@@ -480,6 +480,13 @@ s32 DoCDVDreadTrack(u32 lsn, int mode)
 	return CDVD->readTrack(lsn,mode);
 }
 
+// Not part of the plugin API, only the internal iso reader can make use of it.
+void DoCDVDprefetch(u32 lsn)
+{
+	if (m_CurrentSourceType == CDVD_SourceType::Iso)
+		ISOprefetch(lsn);
+}
+
 s32 DoCDVDgetBuffer(u8* buffer)
 {
 	CheckNullCDVD();
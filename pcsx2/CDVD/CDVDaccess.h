@@ -76,6 +76,7 @@ extern bool DoCDVDopen();
 extern void DoCDVDclose();
 extern s32  DoCDVDreadSector(u8* buffer, u32 lsn, int mode);
 extern s32  DoCDVDreadTrack(u32 lsn, int mode);
+extern void DoCDVDprefetch(u32 lsn);
 extern s32  DoCDVDgetBuffer(u8* buffer);
 extern s32  DoCDVDdetectDiskType();
 extern void DoCDVDresetDiskTypeCache();
@@ -371,6 +371,11 @@ s32 CALLBACK ISOreadTrack(u32 lsn, int mode)
 	return 0;
 }
 
+void ISOprefetch(u32 lsn)
+{
+	iso.Prefetch(lsn);
+}
+
 s32 CALLBACK ISOgetBuffer2(u8* buffer)
 {
 	return iso.FinishRead3(buffer, pmode);
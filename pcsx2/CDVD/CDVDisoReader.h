@@ -21,4 +21,6 @@
 #include "IopCommon.h"
 #include "IsoFileFormats.h"
 
+extern void ISOprefetch(u32 lsn);
+
 #endif
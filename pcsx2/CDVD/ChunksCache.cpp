@@ -17,36 +17,121 @@
 #include "ChunksCache.h"
 
 void ChunksCache::SetLimit(uint megabytes) {
+	std::lock_guard<std::mutex> lock(m_lock);
 	m_limit = (PX_off_t)megabytes * 1024 * 1024;
 	MatchLimit();
 }
 
+void ChunksCache::Clear() {
+	std::lock_guard<std::mutex> lock(m_lock);
+	MatchLimit(true);
+	m_maxCoverage = 0;
+}
+
+void ChunksCache::Remove(EntryMap::iterator it) {
+	CacheEntry* e = it->second;
+	m_size -= e->size;
+	m_lru.erase(e->lru);
+	m_entries.erase(it);
+	delete e;
+}
+
 void ChunksCache::MatchLimit(bool removeAll) {
-	std::list<CacheEntry*>::reverse_iterator rit;
-	while (!m_entries.empty() && (removeAll || m_size > m_limit)) {
-		rit = m_entries.rbegin();
-		m_size -= (*rit)->size;
-		delete(*rit);
-		m_entries.pop_back();
+	while (!m_lru.empty() && (removeAll || m_size > m_limit)) {
+		Remove(m_entries.find(m_lru.back()->offset));
+		if (!removeAll)
+			m_evictions++;
 	}
 }
 
+// Entries don't overlap in practice, but nothing enforces it. Walk back from the
+// closest entry as long as an entry starting there could still cover the request.
+ChunksCache::CacheEntry* ChunksCache::Find(PX_off_t offset, int length) {
+	EntryMap::iterator it = m_entries.upper_bound(offset);
+	while (it != m_entries.begin()) {
+		--it;
+		CacheEntry* e = it->second;
+		if (e->offset + m_maxCoverage < offset + length)
+			break;
+		if ((offset + length) <= (e->offset + e->coverage))
+			return e;
+	}
+	return nullptr;
+}
+
 void ChunksCache::Take(void* pMallocedSrc, PX_off_t offset, int length, int coverage) {
-	m_entries.push_front(new CacheEntry(pMallocedSrc, offset, length, coverage));
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	EntryMap::iterator it = m_entries.find(offset);
+	if (it != m_entries.end())
+		Remove(it); // Newer data wins
+
+	CacheEntry* e = new CacheEntry(pMallocedSrc, offset, length, coverage);
+	m_lru.push_front(e);
+	e->lru = m_lru.begin();
+	m_entries[offset] = e;
+
 	m_size += length;
+	m_maxCoverage = std::max(m_maxCoverage, coverage);
 	MatchLimit();
+	m_peak = std::max(m_peak, m_size);
 }
 
 // By design, succeed only if the entire request is in a single cached chunk
 int ChunksCache::Read(void* pDest, PX_off_t offset, int length) {
-	for (auto it = m_entries.begin(); it != m_entries.end(); it++) {
-		CacheEntry* e = *it;
-		if (e && offset >= e->offset && (offset + length) <= (e->offset + e->coverage)) {
-			if (it != m_entries.begin())
-				m_entries.splice(m_entries.begin(), m_entries, it); // Move to top (MRU)
-			return CopyAvailable(e->data, e->offset, e->size, pDest, offset, length);
-		}
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	CacheEntry* e = Find(offset, length);
+	if (!e) {
+		m_misses++;
+		return -1;
 	}
-	return -1;
+
+	if (e->lru != m_lru.begin())
+		m_lru.splice(m_lru.begin(), m_lru, e->lru); // Move to top (MRU)
+
+	int copied = CopyAvailable(e->data, e->offset, e->size, pDest, offset, length);
+	m_hits++;
+	m_bytesRead += copied;
+	return copied;
+}
+
+bool ChunksCache::Contains(PX_off_t offset, int length) {
+	std::lock_guard<std::mutex> lock(m_lock);
+	return Find(offset, length) != nullptr;
 }
 
+ChunksCache::Stats ChunksCache::GetStats() {
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	Stats s;
+	s.hits        = m_hits;
+	s.misses      = m_misses;
+	s.evictions   = m_evictions;
+	s.bytesRead   = m_bytesRead;
+	s.bytesCached = m_size;
+	s.bytesPeak   = m_peak;
+	s.limit       = m_limit;
+	s.entries     = m_entries.size();
+	return s;
+}
+
+void ChunksCache::ResetStats() {
+	std::lock_guard<std::mutex> lock(m_lock);
+	m_hits = 0;
+	m_misses = 0;
+	m_evictions = 0;
+	m_bytesRead = 0;
+	m_peak = m_size;
+}
+
+void ChunksCache::PrintStats(const char* name) {
+	Stats s = GetStats();
+	u64 lookups = s.hits + s.misses;
+	if (!lookups)
+		return;
+
+	DevCon.WriteLn("%s cache: %u hits / %u misses (%.1f%% hit rate), %u evictions, %.1f MB served, peak %.1f MB of %.1f MB",
+	               name, (uint)s.hits, (uint)s.misses, 100.0 * s.hits / lookups, (uint)s.evictions,
+	               (double)s.bytesRead / _1mb, (double)s.bytesPeak / _1mb, (double)s.limit / _1mb);
+}
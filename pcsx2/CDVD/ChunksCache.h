@@ -15,19 +15,44 @@
 
 #pragma once
 
+#include <list>
+#include <map>
+#include <mutex>
+
 #include "zlib_indexed.h"
 
 #define CLAMP(val, minval, maxval) (std::min(maxval, std::max(minval, val)))
 
+// Cache of decompressed chunks, shared by the compressed readers.
+// Chunks are indexed by offset (O(log n) lookup) and evicted in LRU order once
+// their total size goes above the limit. All the methods are thread safe, so
+// background decompression threads can feed it while the CDVD thread reads.
 class ChunksCache {
 public:
-	ChunksCache(uint initialLimitMb) : m_entries(0), m_size(0), m_limit(initialLimitMb * 1024 * 1024) {};
+	struct Stats {
+		u64 hits;
+		u64 misses;
+		u64 evictions;
+		u64 bytesRead;   // bytes served from the cache
+		u64 bytesCached; // bytes currently held
+		u64 bytesPeak;   // highest bytesCached since the last ResetStats
+		u64 entries;
+		u64 limit;
+	};
+
+	ChunksCache(uint initialLimitMb) : m_size(0), m_limit((PX_off_t)initialLimitMb * 1024 * 1024), m_maxCoverage(0) { ResetStats(); };
 	~ChunksCache() { Clear(); };
 	void SetLimit(uint megabytes);
-	void Clear() { MatchLimit(true); };
+	void Clear();
 
 	void Take(void* pMallocedSrc, PX_off_t offset, int length, int coverage);
 	int  Read(void* pDest,        PX_off_t offset, int length);
+	// Same lookup as Read, without copying nor touching the LRU order or the stats
+	bool Contains(PX_off_t offset, int length);
+
+	Stats GetStats();
+	void  ResetStats();
+	void  PrintStats(const char* name);
 
 	static int CopyAvailable(void* pSrc, PX_off_t srcOffset, int srcSize,
 							 void* pDst, PX_off_t dstOffset, int maxCopySize) {
@@ -52,12 +77,27 @@ private:
 		PX_off_t offset;
 		int coverage;
 		int size;
+		std::list<CacheEntry*>::iterator lru;
 	};
 
-	std::list<CacheEntry*> m_entries;
+	typedef std::map<PX_off_t, CacheEntry*> EntryMap;
+
+	CacheEntry* Find(PX_off_t offset, int length);
+	void Remove(EntryMap::iterator it);
 	void MatchLimit(bool removeAll = false);
+
+	std::mutex m_lock;
+	EntryMap m_entries;             // by offset
+	std::list<CacheEntry*> m_lru;   // most recently used first
 	PX_off_t m_size;
 	PX_off_t m_limit;
+	int m_maxCoverage;              // bounds the backward search in Find()
+
+	u64 m_hits;
+	u64 m_misses;
+	u64 m_evictions;
+	u64 m_bytesRead;
+	PX_off_t m_peak;
 };
 
 #undef CLAMP
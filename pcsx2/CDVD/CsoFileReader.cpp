@@ -89,6 +89,8 @@ bool CsoFileReader::Open(const wxString& fileName) {
 		Close();
 		return false;
 	}
+
+	StartWorkers();
 	return true;
 }
 
@@ -126,10 +128,11 @@ bool CsoFileReader::InitializeBuffers() {
 
 	// We might read a bit of alignment too, so be prepared.
 	if (m_frameSize + (1 << m_indexShift) < CSO_READ_BUFFER_SIZE) {
-		m_readBuffer = new u8[CSO_READ_BUFFER_SIZE];
+		m_readBufferSize = CSO_READ_BUFFER_SIZE;
 	} else {
-		m_readBuffer = new u8[m_frameSize + (1 << m_indexShift)];
+		m_readBufferSize = m_frameSize + (1 << m_indexShift);
 	}
+	m_readBuffer = new u8[m_readBufferSize];
 
 	// This is a buffer for the most recently decompressed frame.
 	m_zlibBuffer = new u8[m_frameSize + (1 << m_indexShift)];
@@ -142,23 +145,36 @@ bool CsoFileReader::InitializeBuffers() {
 		return false;
 	}
 
-	m_z_stream = new z_stream;
-	m_z_stream->zalloc = Z_NULL;
-	m_z_stream->zfree = Z_NULL;
-	m_z_stream->opaque = Z_NULL;
-	if (inflateInit2(m_z_stream, -15) != Z_OK) {
-		Console.Error("Unable to initialize zlib for CSO decompression.");
+	m_z_stream = CreateZStream();
+	if (!m_z_stream) {
 		return false;
 	}
 
 	return true;
 }
 
+z_stream* CsoFileReader::CreateZStream() {
+	z_stream* z = new z_stream;
+	z->zalloc = Z_NULL;
+	z->zfree = Z_NULL;
+	z->opaque = Z_NULL;
+	if (inflateInit2(z, -15) != Z_OK) {
+		Console.Error("Unable to initialize zlib for CSO decompression.");
+		delete z;
+		return NULL;
+	}
+	return z;
+}
+
 void CsoFileReader::Close() {
+	// The workers use the index and the file, they must be gone first.
+	StopWorkers();
+
 	m_filename.Empty();
-#if CSO_USE_CHUNKSCACHE
+	m_cache.PrintStats("CSO");
 	m_cache.Clear();
-#endif
+	m_cache.ResetStats();
+	m_asyncPending = false;
 
 	if (m_src) {
 		fclose(m_src);
@@ -166,6 +182,7 @@ void CsoFileReader::Close() {
 	}
 	if (m_z_stream) {
 		inflateEnd(m_z_stream);
+		delete m_z_stream;
 		m_z_stream = NULL;
 	}
 
@@ -198,27 +215,25 @@ int CsoFileReader::ReadSync(void* pBuffer, uint sector, uint count) {
 	int bytes = 0;
 
 	while (remaining > 0) {
-		int readBytes;
+		// Try first to read from the cache, which the workers fill with whole frames.
+		// A cache entry holds a single frame, so look up one frame at a time.
+		const u64 frameStart = ((pos + bytes) >> m_frameShift) << m_frameShift;
+		const int frameBytes = (int)std::min<u64>(remaining, frameStart + m_frameSize - (pos + bytes));
+		int readBytes = m_cache.Read(dest + bytes, pos + bytes, frameBytes);
+
+		if (readBytes < 0 && m_workers.GetWorkerCount()) {
+			// A worker may be inflating this frame already, it's cheaper to wait for it.
+			if (m_workers.Wait(frameStart)) {
+				readBytes = m_cache.Read(dest + bytes, pos + bytes, frameBytes);
+			}
+		}
 
-#if CSO_USE_CHUNKSCACHE
-		// Try first to read from the cache.
-		readBytes = m_cache.Read(dest + bytes, pos + bytes, remaining);
-#else
-		readBytes = -1;
-#endif
 		if (readBytes < 0) {
 			readBytes = ReadFromFrame(dest + bytes, pos + bytes, remaining);
 			if (readBytes == 0) {
 				// We hit EOF.
 				break;
 			}
-
-#if CSO_USE_CHUNKSCACHE
-			// Add the bytes into the cache.  We need to allocate a buffer for it.
-			void *cached = malloc(readBytes);
-			memcpy(cached, dest + bytes, readBytes);
-			m_cache.Take(cached, pos + bytes, readBytes, readBytes);
-#endif
 		}
 
 		bytes += readBytes;
@@ -242,11 +257,9 @@ int CsoFileReader::ReadFromFrame(u8 *dest, u64 pos, int maxBytes) {
 	// Grab the index data for the frame we're about to read.
 	const bool compressed = (m_index[frame + 0] & 0x80000000) == 0;
 	const u32 index0 = m_index[frame + 0] & 0x7FFFFFFF;
-	const u32 index1 = m_index[frame + 1] & 0x7FFFFFFF;
 
-	// Calculate where the compressed payload is (if compressed.)
+	// Calculate where the payload is.
 	const u64 frameRawPos = (u64)index0 << m_indexShift;
-	const u64 frameRawSize = (u64)(index1 - index0) << m_indexShift;
 
 	if (!compressed) {
 		// Just read directly, easy.
@@ -258,16 +271,12 @@ int CsoFileReader::ReadFromFrame(u8 *dest, u64 pos, int maxBytes) {
 	} else {
 		// We don't need to decompress if we already did this same frame last time.
 		if (m_zlibBufferFrame != frame) {
-			if (PX_fseeko(m_src, m_dataoffset + frameRawPos, SEEK_SET) != 0) {
-				Console.Error("Unable to seek to compressed CSO data.");
-				return 0;
-			}
-			// This might be less bytes than frameRawSize in case of padding on the last frame.
-			// This is because the index positions must be aligned.
-			const u32 readRawBytes = fread(m_readBuffer, 1, frameRawSize, m_src);
-			if (!DecompressFrame(frame, readRawBytes)) {
+			if (ReadFrame(m_src, m_z_stream, m_readBuffer, frame, m_zlibBuffer) == 0) {
+				m_zlibBufferFrame = (u32)-1;
 				return 0;
 			}
+			// Our buffer now contains this frame.
+			m_zlibBufferFrame = frame;
 		}
 
 		// Now we just copy the offset data from the cache.
@@ -277,37 +286,183 @@ int CsoFileReader::ReadFromFrame(u8 *dest, u64 pos, int maxBytes) {
 	return bytes;
 }
 
-bool CsoFileReader::DecompressFrame(u32 frame, u32 readBufferSize) {
-	m_z_stream->next_in = m_readBuffer;
-	m_z_stream->avail_in = readBufferSize;
-	m_z_stream->next_out = m_zlibBuffer;
-	m_z_stream->avail_out = m_frameSize;
-
-	int status = inflate(m_z_stream, Z_FINISH);
-	bool success = status == Z_STREAM_END && m_z_stream->total_out == m_frameSize;
-	if (success) {
-		// Our buffer now contains this frame.
-		m_zlibBufferFrame = frame;
-	} else {
+// Reads a whole frame into dest, which must hold m_frameSize bytes. Only touches the
+// given file handle, zlib state and read buffer, so it's safe to call from a worker.
+// Returns the number of bytes stored in dest, 0 on failure.
+u32 CsoFileReader::ReadFrame(FILE* src, z_stream* z, u8* readBuffer, u32 frame, u8* dest) {
+	const bool compressed = (m_index[frame + 0] & 0x80000000) == 0;
+	const u32 index0 = m_index[frame + 0] & 0x7FFFFFFF;
+	const u32 index1 = m_index[frame + 1] & 0x7FFFFFFF;
+
+	const u64 frameRawPos = (u64)index0 << m_indexShift;
+	const u64 frameRawSize = (u64)(index1 - index0) << m_indexShift;
+
+	if (!compressed) {
+		if (PX_fseeko(src, m_dataoffset + frameRawPos, SEEK_SET) != 0) {
+			Console.Error("Unable to seek to uncompressed CSO data.");
+			return 0;
+		}
+		return fread(dest, 1, m_frameSize, src);
+	}
+
+	if (PX_fseeko(src, m_dataoffset + frameRawPos, SEEK_SET) != 0) {
+		Console.Error("Unable to seek to compressed CSO data.");
+		return 0;
+	}
+	// This might be less bytes than frameRawSize in case of padding on the last frame.
+	// This is because the index positions must be aligned.
+	const u32 readRawBytes = fread(readBuffer, 1, std::min<u64>(frameRawSize, m_readBufferSize), src);
+
+	z->next_in = readBuffer;
+	z->avail_in = readRawBytes;
+	z->next_out = dest;
+	z->avail_out = m_frameSize;
+
+	int status = inflate(z, Z_FINISH);
+	bool success = status == Z_STREAM_END && z->total_out == m_frameSize;
+	if (!success) {
 		Console.Error("Unable to decompress CSO frame using zlib.");
-		m_zlibBufferFrame = (u32)-1;
 	}
 
-	inflateReset(m_z_stream);
-	return success;
+	inflateReset(z);
+	return success ? m_frameSize : 0;
+}
+
+void CsoFileReader::StartWorkers() {
+	StopWorkers();
+
+	int count = DecompressWorkerPool::GetDefaultWorkerCount();
+	for (int i = 0; i < count; i++) {
+		WorkerContext ctx;
+		ctx.src = PX_fopen_rb(m_filename);
+		if (!ctx.src)
+			break;
+		ctx.zstream = CreateZStream();
+		if (!ctx.zstream) {
+			fclose(ctx.src);
+			break;
+		}
+		ctx.readBuffer = new u8[m_readBufferSize];
+		m_worker_ctx.push_back(ctx);
+	}
+
+	if (m_worker_ctx.empty())
+		return;
+
+	m_workers.Start(m_worker_ctx.size());
+	DevCon.WriteLn(L"CSO: %d background decompression workers", (int)m_worker_ctx.size());
+}
+
+void CsoFileReader::StopWorkers() {
+	m_workers.Stop();
+
+	for (WorkerContext& ctx : m_worker_ctx) {
+		fclose(ctx.src);
+		inflateEnd(ctx.zstream);
+		delete ctx.zstream;
+		delete[] ctx.readBuffer;
+	}
+	m_worker_ctx.clear();
+
+	m_prefetchStart = m_prefetchEnd = 0;
+}
+
+// Hands frames [first, last] to the workers, in order, skipping the ones which
+// were already scheduled for the current read position.
+void CsoFileReader::QueueFrames(u32 first, u32 last) {
+	last = std::min(last, GetFrameCount() - 1);
+
+	// Anything queued for a previous location is now useless
+	if (first < m_prefetchStart || first > m_prefetchEnd) {
+		m_workers.CancelQueued();
+		m_prefetchEnd = first;
+	}
+	m_prefetchStart = first;
+
+	for (u32 frame = std::max(first, m_prefetchEnd); frame <= last; frame++) {
+		const u64 frameStart = (u64)frame << m_frameShift;
+		if (m_cache.Contains(frameStart, 1))
+			continue;
+
+		m_workers.Queue(frameStart, [this, frame](int worker) { DecompressFrameAsync(worker, frame); });
+	}
+
+	m_prefetchEnd = std::max(m_prefetchEnd, last + 1);
+}
+
+// Runs on a worker thread
+void CsoFileReader::DecompressFrameAsync(int worker, u32 frame) {
+	const u64 frameStart = (u64)frame << m_frameShift;
+	if (m_cache.Contains(frameStart, 1))
+		return;
+
+	WorkerContext& ctx = m_worker_ctx[worker];
+	u8* data = (u8*)malloc(m_frameSize);
+	const u32 bytes = ReadFrame(ctx.src, ctx.zstream, ctx.readBuffer, frame, data);
+	if (bytes == 0) {
+		free(data);
+		return;
+	}
+
+	// The last frame may hold padding past the end of the image
+	const int length = (int)std::min<u64>(bytes, m_totalSize - frameStart);
+	m_cache.Take(data, frameStart, length, length);
+}
+
+void CsoFileReader::SetDataOffset(int bytes) {
+	if (bytes == m_dataoffset) {
+		return;
+	}
+
+	// Everything decompressed so far was read relative to the old offset.
+	const int workers = m_workers.GetWorkerCount();
+	m_workers.Stop();
+	m_cache.Clear();
+	m_zlibBufferFrame = (u32)-1;
+	m_prefetchStart = m_prefetchEnd = 0;
+
+	m_dataoffset = bytes;
+
+	if (workers) {
+		m_workers.Start(workers);
+	}
 }
 
 void CsoFileReader::BeginRead(void* pBuffer, uint sector, uint count) {
-	// TODO: No async support yet, implement as sync.
-	m_bytesRead = ReadSync(pBuffer, sector, count);
+	if (!m_src || !m_workers.GetWorkerCount()) {
+		m_asyncPending = false;
+		m_bytesRead = ReadSync(pBuffer, sector, count);
+		return;
+	}
+
+	m_asyncBuffer = pBuffer;
+	m_asyncSector = sector;
+	m_asyncCount = count;
+	m_asyncPending = true;
+
+	const u64 pos = (u64)sector * (u64)m_blocksize;
+	if (pos >= m_totalSize) {
+		return;
+	}
+
+	// The frames of the request go first so the workers pick them up before the read-ahead.
+	const u64 end = std::min(pos + (u64)count * m_blocksize, m_totalSize) - 1;
+	QueueFrames((u32)(pos >> m_frameShift), (u32)((end + CSO_READAHEAD_SIZE) >> m_frameShift));
 }
 
 int CsoFileReader::FinishRead() {
+	if (m_asyncPending) {
+		m_asyncPending = false;
+		return ReadSync(m_asyncBuffer, m_asyncSector, m_asyncCount);
+	}
+
 	int res = m_bytesRead;
 	m_bytesRead = -1;
 	return res;
 }
 
 void CsoFileReader::CancelRead() {
-	// TODO: No async read support yet.
+	// Queued frames are kept, they're likely to be wanted by the next read anyway.
+	m_asyncPending = false;
+	m_bytesRead = -1;
 }
@@ -15,22 +15,23 @@
 
 #pragma once
 
-// Based on testing, the overhead of using this cache is high.
-//
-// The test was done with CSO files using a block size of 16KB.
-// Cache hit rates were observed in the range of 25%.
-// Cache overhead added 35% to the overall read time.
-//
-// For this reason, it's currently disabled.
-#define CSO_USE_CHUNKSCACHE 0
+// Frames are inflated by a small pool of background workers and kept in the
+// ChunksCache, one entry per frame. BeginRead() schedules the frames of the
+// request plus a read-ahead window, FinishRead() waits for the ones it needs.
+// Without workers (or from ReadSync) frames are inflated on the calling thread.
+
+#include <vector>
 
 #include "AsyncFileReader.h"
 #include "ChunksCache.h"
+#include "DecompressWorkerPool.h"
 
 struct CsoHeader;
 typedef struct z_stream_s z_stream;
 
 static const uint CSO_CHUNKCACHE_SIZE_MB = 200;
+// Amount of data (in bytes) which BeginRead() schedules past the end of the request
+static const uint CSO_READAHEAD_SIZE = 1024 * 1024;
 
 class CsoFileReader : public AsyncFileReader
 {
@@ -47,9 +48,14 @@ public:
 		m_totalSize(0),
 		m_src(0),
 		m_z_stream(0),
-#if CSO_USE_CHUNKSCACHE
+		m_readBufferSize(0),
 		m_cache(CSO_CHUNKCACHE_SIZE_MB),
-#endif
+		m_prefetchStart(0),
+		m_prefetchEnd(0),
+		m_asyncBuffer(0),
+		m_asyncSector(0),
+		m_asyncCount(0),
+		m_asyncPending(false),
 		m_bytesRead(0) {
 		m_blocksize = 2048;
 	};
@@ -72,14 +78,28 @@ public:
 	};
 
 	virtual void SetBlockSize(uint bytes) { m_blocksize = bytes; }
-	virtual void SetDataOffset(int bytes) { m_dataoffset = bytes; }
+	virtual void SetDataOffset(int bytes);
 
 private:
+	// Resources owned by one decompression worker, so workers never share a file position or zlib state
+	struct WorkerContext {
+		FILE* src;
+		z_stream* zstream;
+		u8* readBuffer;
+	};
+
 	static bool ValidateHeader(const CsoHeader& hdr);
 	bool ReadFileHeader();
 	bool InitializeBuffers();
+	z_stream* CreateZStream();
 	int ReadFromFrame(u8 *dest, u64 pos, int maxBytes);
-	bool DecompressFrame(u32 frame, u32 readBufferSize);
+	u32 ReadFrame(FILE* src, z_stream* z, u8* readBuffer, u32 frame, u8* dest);
+
+	void StartWorkers();
+	void StopWorkers();
+	void QueueFrames(u32 first, u32 last);
+	void DecompressFrameAsync(int worker, u32 frame);
+	u32 GetFrameCount() const { return (u32)((m_totalSize + m_frameSize - 1) >> m_frameShift); }
 
 	u32 m_frameSize;
 	u8 m_frameShift;
@@ -92,11 +112,23 @@ private:
 	// The actual source cso file handle.
 	FILE* m_src;
 	z_stream* m_z_stream;
+	u32 m_readBufferSize;
 
-#if CSO_USE_CHUNKSCACHE
+	// Whole decompressed frames, indexed by their uncompressed offset.
 	ChunksCache m_cache;
-#endif
 
-	// The result of a read is stored here between BeginRead() and FinishRead().
+	DecompressWorkerPool m_workers;
+	std::vector<WorkerContext> m_worker_ctx;
+	// Frames [m_prefetchStart, m_prefetchEnd) were already handed to the workers.
+	u32 m_prefetchStart;
+	u32 m_prefetchEnd;
+
+	// The request is stored here between BeginRead() and FinishRead().
+	void* m_asyncBuffer;
+	uint m_asyncSector;
+	uint m_asyncCount;
+	bool m_asyncPending;
+
+	// The result of a synchronous read is stored here between BeginRead() and FinishRead().
 	int m_bytesRead;
 };
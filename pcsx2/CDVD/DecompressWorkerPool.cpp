@@ -0,0 +1,119 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2017  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "PrecompiledHeader.h"
+#include "DecompressWorkerPool.h"
+
+void DecompressWorkerPool::Start(int workers) {
+	Stop();
+
+	m_quit = false;
+	for (int i = 0; i < workers; i++)
+		m_threads.push_back(std::thread(&DecompressWorkerPool::WorkerThread, this, i));
+}
+
+void DecompressWorkerPool::Stop() {
+	if (m_threads.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		m_quit = true;
+		for (auto& job : m_queue)
+			m_busy.erase(job.key);
+		m_queue.clear();
+	}
+	m_cv_work.notify_all();
+
+	for (auto& t : m_threads)
+		t.join();
+	m_threads.clear();
+
+	// Nothing can be running anymore, release any waiter
+	std::lock_guard<std::mutex> lock(m_lock);
+	m_busy.clear();
+	m_cv_done.notify_all();
+}
+
+bool DecompressWorkerPool::Queue(PX_off_t key, Task task) {
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+		if (m_threads.empty() || m_quit || m_busy.count(key))
+			return false;
+
+		m_busy.insert(key);
+		m_queue.push_back({key, std::move(task)});
+	}
+	m_cv_work.notify_one();
+
+	return true;
+}
+
+bool DecompressWorkerPool::IsBusy(PX_off_t key) {
+	std::lock_guard<std::mutex> lock(m_lock);
+	return m_busy.count(key) != 0;
+}
+
+bool DecompressWorkerPool::Wait(PX_off_t key) {
+	std::unique_lock<std::mutex> lock(m_lock);
+	if (!m_busy.count(key))
+		return false;
+
+	// Jump the queue if no worker picked it up yet
+	for (auto it = m_queue.begin(); it != m_queue.end(); ++it) {
+		if (it->key == key) {
+			if (it != m_queue.begin()) {
+				Job job = std::move(*it);
+				m_queue.erase(it);
+				m_queue.push_front(std::move(job));
+			}
+			break;
+		}
+	}
+
+	m_cv_done.wait(lock, [&] { return !m_busy.count(key); });
+	return true;
+}
+
+void DecompressWorkerPool::CancelQueued() {
+	std::lock_guard<std::mutex> lock(m_lock);
+	for (auto& job : m_queue)
+		m_busy.erase(job.key);
+	m_queue.clear();
+	m_cv_done.notify_all();
+}
+
+void DecompressWorkerPool::WorkerThread(int id) {
+	for (;;) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			m_cv_work.wait(lock, [&] { return m_quit || !m_queue.empty(); });
+			if (m_quit)
+				return;
+
+			job = std::move(m_queue.front());
+			m_queue.pop_front();
+		}
+
+		job.task(id);
+
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+			m_busy.erase(job.key);
+		}
+		m_cv_done.notify_all();
+	}
+}
@@ -0,0 +1,79 @@
+/*  PCSX2 - PS2 Emulator for PCs
+*  Copyright (C) 2002-2017  PCSX2 Dev Team
+*
+*  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+*  of the GNU Lesser General Public License as published by the Free Software Found-
+*  ation, either version 3 of the License, or (at your option) any later version.
+*
+*  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+*  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+*  PURPOSE.  See the GNU General Public License for more details.
+*
+*  You should have received a copy of the GNU General Public License along with PCSX2.
+*  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <set>
+#include <vector>
+
+#include "CompressedFileReaderUtils.h"
+
+// Small pool of threads used by the compressed readers to inflate upcoming
+// data in the background. Every task is identified by a key (the uncompressed
+// offset it produces) so a reader never schedules the same work twice, and can
+// wait for data which a worker is already decompressing instead of doing it again.
+// Tasks receive the index of the worker which runs them, so readers can keep
+// per-worker resources (file handles, inflate states) without locking.
+class DecompressWorkerPool {
+public:
+	typedef std::function<void(int worker)> Task;
+
+	DecompressWorkerPool() : m_quit(false) {};
+	~DecompressWorkerPool() { Stop(); };
+
+	void Start(int workers);
+	void Stop(); // Drops queued tasks and joins the workers once running tasks are done
+
+	int GetWorkerCount() const { return (int)m_threads.size(); }
+
+	// Returns false if a task with the same key is already queued or running
+	bool Queue(PX_off_t key, Task task);
+	// Returns true if a task with this key is queued or running
+	bool IsBusy(PX_off_t key);
+	// If the task is still queued it's moved to the front. Blocks until it's done.
+	// Returns false if there was nothing to wait for.
+	bool Wait(PX_off_t key);
+	// Drops all the tasks which haven't started yet
+	void CancelQueued();
+
+	// Leave one core to the emulation threads, and more than 4 workers won't
+	// help since the CDVD consumption rate is way lower.
+	static int GetDefaultWorkerCount() {
+		int cores = (int)std::thread::hardware_concurrency();
+		return std::max(1, std::min(4, cores - 1));
+	};
+
+private:
+	struct Job {
+		PX_off_t key;
+		Task task;
+	};
+
+	void WorkerThread(int id);
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_lock;
+	std::condition_variable m_cv_work;
+	std::condition_variable m_cv_done;
+	std::deque<Job> m_queue;
+	std::set<PX_off_t> m_busy; // keys of the queued and running tasks
+	bool m_quit;
+};
@@ -182,7 +182,8 @@ GzippedFileReader::GzippedFileReader(void) :
 	m_pIndex(0),
 	m_zstates(0),
 	m_src(0),
-	m_cache(GZFILE_CACHE_SIZE_MB) {
+	m_cache(GZFILE_CACHE_SIZE_MB),
+	m_last_prefetch(-1) {
 	m_blocksize = 2048;
 	AsyncPrefetchReset();
 };
@@ -335,6 +336,7 @@ bool GzippedFileReader::Open(const wxString& fileName) {
 	};
 
 	AsyncPrefetchOpen();
+	StartWorkers();
 	return true;
 };
 
@@ -401,10 +403,19 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 
 	// From here onwards it's guarenteed that the request is inside a single GZFILE_READ_CHUNK_SIZE boundaries
 
+	PrefetchSpans(offset);
+
 	int res = m_cache.Read(pBuffer, offset, bytesToRead);
 	if (res >= 0)
 		return res;
 
+	// A worker may be inflating this span already, it's cheaper to wait for it
+	if (m_workers.Wait(offset / m_pIndex->span * m_pIndex->span)) {
+		res = m_cache.Read(pBuffer, offset, bytesToRead);
+		if (res >= 0)
+			return res;
+	}
+
 	// Not available from cache. Decompress from optimal starting
 	// point in GZFILE_READ_CHUNK_SIZE chunks and cache each chunk.
 	PTT s = NOW();
@@ -462,7 +473,100 @@ int GzippedFileReader::_ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRea
 	return copied;
 }
 
+// The workers inflate whole spans starting at their index access point, so each
+// one is independent of the others and of the sequential zstates used by _ReadSync.
+void GzippedFileReader::StartWorkers() {
+	StopWorkers();
+
+	// Chunks must not straddle spans
+	if (m_pIndex->span % GZFILE_READ_CHUNK_SIZE)
+		return;
+
+	int count = DecompressWorkerPool::GetDefaultWorkerCount();
+	for (int i = 0; i < count; i++) {
+		FILE* src = PX_fopen_rb(m_filename);
+		if (!src)
+			break;
+		m_worker_src.push_back(src);
+	}
+
+	if (m_worker_src.empty())
+		return;
+
+	m_workers.Start(m_worker_src.size());
+	DevCon.WriteLn(L"gunzip: %d background decompression workers", (int)m_worker_src.size());
+}
+
+void GzippedFileReader::StopWorkers() {
+	m_workers.Stop();
+
+	for (FILE* src : m_worker_src)
+		fclose(src);
+	m_worker_src.clear();
+
+	m_last_prefetch = -1;
+}
+
+void GzippedFileReader::PrefetchSpans(PX_off_t offset) {
+	if (!m_workers.GetWorkerCount())
+		return;
+
+	int span = m_pIndex->span;
+	int spanix = offset / span;
+	if (spanix == m_last_prefetch)
+		return;
+
+	// Anything queued for a previous location is now useless
+	if (spanix < m_last_prefetch || spanix > m_last_prefetch + GZFILE_PREFETCH_SPANS)
+		m_workers.CancelQueued();
+	m_last_prefetch = spanix;
+
+	int lastix = (int)((m_pIndex->uncompressed_size - 1) / span);
+	for (int ix = spanix + 1; ix <= std::min(lastix, spanix + GZFILE_PREFETCH_SPANS); ix++) {
+		PX_off_t start = (PX_off_t)ix * span;
+		if (m_cache.Contains(start, 1))
+			continue;
+
+		m_workers.Queue(start, [this, ix](int worker) { InflateSpan(worker, ix); });
+	}
+}
+
+// Runs on a worker thread
+void GzippedFileReader::InflateSpan(int worker, int spanix) {
+	PTT s = NOW();
+	int span = m_pIndex->span;
+	PX_off_t start = (PX_off_t)spanix * span;
+	PX_off_t end = std::min(start + span, m_pIndex->uncompressed_size);
+
+	Czstate zstate; // consecutive extract() calls continue from it instead of the index
+	for (PX_off_t offset = start; offset < end; offset += GZFILE_READ_CHUNK_SIZE) {
+		unsigned char* chunk = (unsigned char*)malloc(GZFILE_READ_CHUNK_SIZE);
+		int res = extract(m_worker_src[worker], m_pIndex, offset, chunk, GZFILE_READ_CHUNK_SIZE, &zstate.state);
+		if (res <= 0) {
+			free(chunk);
+			if (res < 0)
+				Console.Warning(L"gunzip: worker %d failed to inflate span %d (%d)", worker, spanix, res);
+			return;
+		}
+
+		if (m_cache.Contains(offset, 1))
+			free(chunk); // The CDVD thread got there first
+		else
+			m_cache.Take(chunk, offset, res, GZFILE_READ_CHUNK_SIZE);
+
+		if (res < GZFILE_READ_CHUNK_SIZE)
+			break; // EOF
+	}
+
+	int duration = NOW() - s;
+	if (duration > 10)
+		DevCon.WriteLn(Color_Gray, L"gunzip: worker %d span #%5d : %1.2f MB - %d ms",
+		               worker, spanix, (float)(end - start) / 1024 / 1024, duration);
+}
+
 void GzippedFileReader::Close() {
+	StopWorkers();
+
 	m_filename.Empty();
 	if (m_pIndex) {
 		free_index((Access*)m_pIndex);
@@ -470,7 +574,9 @@ void GzippedFileReader::Close() {
 	}
 
 	InitZstates(); // results in delete because no index
+	m_cache.PrintStats("gunzip");
 	m_cache.Clear();
+	m_cache.ResetStats();
 
 	if (m_src) {
 		fclose(m_src);
@@ -19,11 +19,13 @@ typedef struct zstate Zstate;
 
 #include "AsyncFileReader.h"
 #include "ChunksCache.h"
+#include "DecompressWorkerPool.h"
 #include "zlib_indexed.h"
 
 #define GZFILE_SPAN_DEFAULT (1048576L * 4)   /* distance between direct access points when creating a new index */
 #define GZFILE_READ_CHUNK_SIZE (256 * 1024)  /* zlib extraction chunks size (at 0-based boundaries) */
 #define GZFILE_CACHE_SIZE_MB 200             /* cache size for extracted data. must be at least GZFILE_READ_CHUNK_SIZE (in MB)*/
+#define GZFILE_PREFETCH_SPANS 4              /* max number of spans inflated ahead by the background workers */
 
 class GzippedFileReader : public AsyncFileReader
 {
@@ -70,12 +72,22 @@ private:
 	int     _ReadSync(void* pBuffer, PX_off_t offset, uint bytesToRead);
 	void	InitZstates();
 
+	// Background inflate of whole spans from their index access point
+	void    StartWorkers();
+	void    StopWorkers();
+	void    PrefetchSpans(PX_off_t offset);
+	void    InflateSpan(int worker, int spanix);
+
 	int		mBytesRead; // Temp sync read result when simulating async read
 	Access* m_pIndex;   // Quick access index
 	Czstate* m_zstates;
 	FILE*	m_src;
 
-	ChunksCache m_cache;
+	ChunksCache m_cache; // Also fed by the workers
+
+	DecompressWorkerPool m_workers;
+	std::vector<FILE*>   m_worker_src; // One handle per worker since extract() seeks
+	int                  m_last_prefetch; // Span index of the last prefetch request
 
 #ifdef _WIN32
 	// Used by async prefetch
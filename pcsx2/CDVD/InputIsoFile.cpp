@@ -48,6 +48,15 @@ int InputIsoFile::ReadSync(u8* dst, uint lsn)
 	return m_reader->ReadSync(dst+m_blockofs, lsn, 1);
 }
 
+// Lets the reader warm up its caches for an upcoming seek target. Purely a hint.
+void InputIsoFile::Prefetch(uint lsn)
+{
+	if (!m_reader || lsn >= m_blocks)
+		return;
+
+	m_reader->Prefetch(lsn);
+}
+
 void InputIsoFile::BeginRead2(uint lsn)
 {
 	if (lsn > m_blocks)
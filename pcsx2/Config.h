@@ -246,7 +246,10 @@ struct Pcsx2Config
 				PreBlockCheckEE	:1,
 				PreBlockCheckIOP:1;
 			bool
-				EnableEECache   :1;
+				EnableEECache   :1,
+				EnableEETier2	:1;		// recompile hot EE blocks with their forward jumps followed
+			bool
+				EnableVUCache	:1;		// persistent microVU program cache (see microVU_Cache.inl)
 		BITFIELD_END
 
 		RecompilerOptions();
@@ -400,6 +403,7 @@ struct Pcsx2Config
 
 		s8	EECycleRate;		// EE cycle rate selector (1.0, 1.5, 2.0)
 		u8	VUCycleSteal;		// VU Cycle Stealer factor (0, 1, 2, or 3)
+		u16	IopCycleSkew;		// EE cycles the EE may run ahead of the IOP between two syncs (0 = IOP runs at every event test)
 
 		SpeedhackOptions();
 		void LoadSave( IniInterface& conf );
@@ -407,7 +411,7 @@ struct Pcsx2Config
 
 		bool operator ==( const SpeedhackOptions& right ) const
 		{
-			return OpEqu( bitset ) && OpEqu( EECycleRate ) && OpEqu( VUCycleSteal );
+			return OpEqu( bitset ) && OpEqu( EECycleRate ) && OpEqu( VUCycleSteal ) && OpEqu( IopCycleSkew );
 		}
 
 		bool operator !=( const SpeedhackOptions& right ) const
@@ -416,6 +420,32 @@ struct Pcsx2Config
 		}
 	};
 
+	// ------------------------------------------------------------------------
+	struct RewindOptions
+	{
+		BITFIELD32()
+			bool
+				Enabled		:1;		// captures in-memory snapshots while the game runs
+		BITFIELD_END
+
+		int		IntervalVsyncs;		// number of vsyncs between two snapshots
+		int		MemoryLimitMB;		// hard cap for the whole history (compressed snapshots + the current base)
+		int		DeltasPerBase;		// incremental snapshots between two full ones
+
+		RewindOptions();
+		void LoadSave( IniInterface& conf );
+
+		bool operator ==( const RewindOptions& right ) const
+		{
+			return OpEqu( bitset ) && OpEqu( IntervalVsyncs ) && OpEqu( MemoryLimitMB ) && OpEqu( DeltasPerBase );
+		}
+
+		bool operator !=( const RewindOptions& right ) const
+		{
+			return !this->operator ==( right );
+		}
+	};
+
 	struct DebugOptions
 	{
 		BITFIELD32()
@@ -451,6 +481,7 @@ struct Pcsx2Config
 			CdvdVerboseReads	:1,		// enables cdvd read activity verbosely dumped to the console
 			CdvdDumpBlocks		:1,		// enables cdvd block dumping
 			CdvdShareWrite		:1,		// allows the iso to be modified while it's loaded
+			CdvdMapIsoFile		:1,		// memory maps flat iso images (a sliding window) instead of using aio reads (Linux)
 			EnablePatches		:1,		// enables patch detection and application
 			EnableCheats		:1,		// enables cheat detection and application
 			EnableWideScreenPatches		:1,
@@ -473,6 +504,7 @@ struct Pcsx2Config
 	SpeedhackOptions	Speedhacks;
 	GamefixOptions		Gamefixes;
 	ProfilerOptions		Profiler;
+	RewindOptions		Rewind;
 	DebugOptions		Debugger;
 
 	TraceLogFilters		Trace;
@@ -498,6 +530,7 @@ struct Pcsx2Config
 			OpEqu( Speedhacks )	&&
 			OpEqu( Gamefixes )	&&
 			OpEqu( Profiler )	&&
+			OpEqu( Rewind )		&&
 			OpEqu( Trace )		&&
 			OpEqu( BiosFilename );
 	}
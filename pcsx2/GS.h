@@ -304,9 +304,38 @@ struct MTGS_FreezeData
 	s32			retval;		// value returned from the call, valid only after an mtgsWaitGS()
 };
 
+// Producer/consumer stalls of the last complete frame (see SysMtgsThread::GetStallStats).
+struct MTGS_StallStats
+{
+	double		EEStallMs;		// time the EE spent waiting on the MTGS (ring full, vsync queue, WaitGS)
+	uint		EEStalls;		// number of those waits
+	double		GSIdleMs;		// time the MTGS spent waiting for data
+};
+
 // --------------------------------------------------------------------------------------
 //  SysMtgsThread
 // --------------------------------------------------------------------------------------
+// Ring protocol: the ring is single producer (the EE thread) / single consumer (the MTGS
+// thread), and moving data through it takes no lock.
+//
+//  * The EE only stores m_WritePos and the MTGS only stores m_ReadPos.  Stores are release
+//    and loads of the other side's index are acquire, so packet data written before a
+//    m_WritePos update is visible to the MTGS when it sees the new index, and ring space
+//    freed by a m_ReadPos update can be reused by the EE as soon as it sees the index.
+//
+//  * Both sides wait adaptively: spin on the other side's index for a while (it usually
+//    catches up within microseconds), yield a few times, and only then sleep on a semaphore
+//    (a futex on Linux).  The spin budgets grow when spinning pays off and shrink when it
+//    doesn't, so a side that always ends up sleeping stops burning its core.
+//
+//  * m_RingBufferIsBusy is set while the MTGS is awake (processing or spinning), and the
+//    EE skips semaphore posts meanwhile.  The MTGS clears it before sleeping and re-checks
+//    the ring, and SetEvent checks it after the m_WritePos store, both behind full fences:
+//    either the MTGS sees the new data or the EE sees it's going to sleep.
+//
+//  * The busy mutexes are not involved in that; they're only held while packets are being
+//    processed, to give WaitGS (EE or MTVU thread) something to block on.
+//
 class SysMtgsThread : public SysThreadBase
 {
 	typedef SysThreadBase _parent;
@@ -317,7 +346,7 @@ public:
 	std::atomic<unsigned int> m_ReadPos;  // cur pos gs is reading from
 	std::atomic<unsigned int> m_WritePos; // cur pos ee thread is writing to
 
-	std::atomic<bool>	m_RingBufferIsBusy;
+	std::atomic<bool>	m_RingBufferIsBusy;	// MTGS is awake, no need to post m_sem_event
 	std::atomic<bool>	m_SignalRingEnable;
 	std::atomic<int>	m_SignalRingPosition;
 
@@ -348,6 +377,19 @@ public:
 	uint			m_packet_size;		// size of the packet (data only, ie. not including the 16 byte command!)
 	uint			m_packet_writepos;	// index of the data location in the ringbuffer.
 
+	// Adaptive wait budgets, in SpinWait() iterations.
+	uint			m_EESpinBudget;		// EE thread only
+	uint			m_GSSpinBudget;		// MTGS thread only
+
+	// Stall counters, in GetCPUTicks() units.  The running totals are latched at every vsync
+	// (by the EE and by the MTGS respectively) into the m_Frame* values.
+	std::atomic<u64>	m_EEStallTicks;
+	std::atomic<uint>	m_EEStalls;
+	u64					m_GSIdleTicks;		// MTGS thread only
+	std::atomic<u64>	m_FrameEEStallTicks;
+	std::atomic<uint>	m_FrameEEStalls;
+	std::atomic<u64>	m_FrameGSIdleTicks;
+
 #ifdef RINGBUF_DEBUG_STACK
 	Threading::Mutex m_lock_Stack;
 #endif
@@ -377,6 +419,8 @@ public:
 
 	bool IsPluginOpened() const { return m_PluginOpened; }
 
+	MTGS_StallStats GetStallStats() const;
+
 protected:
 	void OpenPlugin();
 	void ClosePlugin();
@@ -390,6 +434,9 @@ protected:
 	void OnCleanupInThread();
 
 	void GenericStall( uint size );
+	bool IsRingEmpty() const;
+	void AddEEStall( u64 startTicks );
+	void LatchEEStalls();
 
 	// Used internally by SendSimplePacket type functions
 	void _FinishSimplePacket();
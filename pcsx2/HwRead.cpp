@@ -147,6 +147,14 @@ mem32_t __fastcall _hwRead32(u32 mem)
 				case MCH_RICM:
 					return 0;
 
+				// The EE polls these for the IOP's side of the SIF: let it catch up
+				case SBUS_F200:
+				case SBUS_F210:
+				case SBUS_F220:
+				case SBUS_F230:
+					iopSyncWithEE( IopSync_SifReg );
+					return psHu32(mem);
+
 				case SBUS_F240:
 #if PSX_EXTRALOGS
 					DevCon.Warning("Read  SBUS_F240  %x ", psHu32(SBUS_F240));
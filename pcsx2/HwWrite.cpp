@@ -166,14 +166,17 @@ void __fastcall _hwWrite32( u32 mem, u32 value )
 				mcase(SBUS_F200):
 					// Performs a standard psHu32 assignment (which is the default action anyway).
 					//psHu32(mem) = value;
+					iopSyncWithEE( IopSync_SifReg );
 				break;
 
 				mcase(SBUS_F220):
 					psHu32(mem) |= value;
+					iopSyncWithEE( IopSync_SifReg );
 				return;
 
 				mcase(SBUS_F230):
 					psHu32(mem) &= ~value;
+					iopSyncWithEE( IopSync_SifReg );
 				return;
 
 				mcase(SBUS_F240) :
@@ -14,13 +14,35 @@
  */
 
 #include "PrecompiledHeader.h"
+#include "Config.h"
 #include "AsyncFileReader.h"
 
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Size of the mapped window. The Linux build is 32 bits, so the whole image
+// can't be mapped: a DVD9 doesn't fit in the address space, and even a DVD5
+// would take most of it.
+static const s64 MappedWindow = 32 * _1mb;
+
+// Amount of data the kernel is asked to read ahead of the current position
+// when the image is mapped.
+static const s64 MappedReadAhead = 8 * _1mb;
+
 FlatFileReader::FlatFileReader(bool shareWrite) : shareWrite(shareWrite)
 {
 	m_blocksize = 2048;
 	m_fd = -1;
 	m_aio_context = 0;
+	m_map_enabled = false;
+	m_file_size = 0;
+	m_mapping = NULL;
+	m_mapping_offset = 0;
+	m_mapping_size = 0;
+	m_advised_start = 0;
+	m_advised_end = 0;
+	m_mapped_pending = false;
+	m_mapped_result = -1;
 }
 
 FlatFileReader::~FlatFileReader(void)
@@ -37,17 +59,146 @@ bool FlatFileReader::Open(const wxString& fileName)
 
     m_fd = wxOpen(fileName, O_RDONLY, 0);
 
+	if (m_fd != -1 && EmuConfig.CdvdMapIsoFile)
+		MapFile();
+
 	return (m_fd != -1);
 }
 
+// The mapping is only used when the image can't change under our feet: a file
+// truncated while mapped raises SIGBUS on access. So does a read error on the
+// underlying device, which is why the option is off by default.
+bool FlatFileReader::MapFile()
+{
+	if (shareWrite)
+		return false;
+
+	struct stat st;
+	if (fstat(m_fd, &st) != 0 || st.st_size <= 0)
+		return false;
+
+	m_file_size = st.st_size;
+	m_map_enabled = true;
+	m_advised_start = m_advised_end = 0;
+
+	if (!MapWindow(0, std::min(m_file_size, MappedWindow)))
+		return false;
+
+	DevCon.WriteLn(L"FlatFileReader: '%s' is memory mapped (%lld MB window).",
+		WX_STR(m_filename), (long long)(m_mapping_size / _1mb));
+
+	return true;
+}
+
+// Maps the window that holds [offset, offset + bytes). Returns false when the
+// range is larger than a window or mmap fails; the latter also disables the
+// mapping for the rest of the session.
+bool FlatFileReader::MapWindow(s64 offset, s64 bytes)
+{
+	s64 page = sysconf(_SC_PAGESIZE);
+	s64 start = offset & ~(page - 1);
+	s64 size = std::min(MappedWindow, m_file_size - start);
+
+	if (offset + bytes > start + size)
+		return false;
+
+	UnmapFile();
+
+	// The 64 bits variants, off_t is 32 bits on the 32 bits build
+	void* ptr = mmap64(NULL, size, PROT_READ, MAP_SHARED, m_fd, start);
+	if (ptr == MAP_FAILED) {
+		Console.Warning(L"FlatFileReader: Can't map '%s' (%s), falling back to aio reads.",
+			WX_STR(m_filename), WX_STR(fromUTF8(strerror(errno))));
+		m_map_enabled = false;
+		return false;
+	}
+
+	m_mapping = (u8*)ptr;
+	m_mapping_offset = start;
+	m_mapping_size = size;
+
+	// Access is mostly streaming, let the kernel read ahead and drop pages behind us
+	madvise(m_mapping, m_mapping_size, MADV_SEQUENTIAL);
+
+	return true;
+}
+
+void FlatFileReader::UnmapFile()
+{
+	if (m_mapping)
+		munmap(m_mapping, m_mapping_size);
+
+	m_mapping = NULL;
+	m_mapping_offset = 0;
+	m_mapping_size = 0;
+}
+
+// Only issue a new POSIX_FADV_WILLNEED when the read position goes past the
+// middle of the previous range (or somewhere else entirely), so sequential
+// reads don't pay a syscall per sector. The advice goes through the fd, so it
+// also works for data that isn't in the current window yet.
+void FlatFileReader::AdviseReadAhead(s64 offset, bool force)
+{
+	if (!force && offset >= m_advised_start && offset < m_advised_end - MappedReadAhead / 2)
+		return;
+
+	s64 page = sysconf(_SC_PAGESIZE);
+	s64 start = std::min(offset, m_file_size) & ~(page - 1);
+	s64 end = std::min(start + MappedReadAhead, m_file_size);
+
+	if (end > start)
+		posix_fadvise64(m_fd, start, end - start, POSIX_FADV_WILLNEED);
+
+	m_advised_start = start;
+	m_advised_end = end;
+}
+
+void FlatFileReader::Prefetch(uint sector)
+{
+	if (!m_map_enabled)
+		return;
+
+	AdviseReadAhead(sector * (s64)m_blocksize + m_dataoffset, true);
+}
+
 int FlatFileReader::ReadSync(void* pBuffer, uint sector, uint count)
 {
-	BeginRead(pBuffer, sector, count);
-	return FinishRead();
+	if (!m_map_enabled) {
+		BeginRead(pBuffer, sector, count);
+		return FinishRead();
+	}
+
+	s64 offset = sector * (s64)m_blocksize + m_dataoffset;
+	s64 bytesToRead = std::min<s64>(count * m_blocksize, m_file_size - offset);
+
+	if (bytesToRead <= 0)
+		return -1;
+
+	AdviseReadAhead(offset, false);
+
+	if (offset < m_mapping_offset || offset + bytesToRead > m_mapping_offset + m_mapping_size) {
+		if (!MapWindow(offset, bytesToRead)) {
+			// Larger than a window, or the mapping just failed
+			ssize_t res = pread64(m_fd, pBuffer, bytesToRead, offset);
+			return (res == bytesToRead) ? (int)res : -1;
+		}
+	}
+
+	memcpy(pBuffer, m_mapping + (offset - m_mapping_offset), bytesToRead);
+
+	return (int)bytesToRead;
 }
 
 void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 {
+	if (m_map_enabled) {
+		// Nothing to wait for, the data is either in the page cache or faulted in now.
+		// ReadSync may drop the mapping, so remember which path FinishRead must take.
+		m_mapped_pending = true;
+		m_mapped_result = ReadSync(pBuffer, sector, count);
+		return;
+	}
+
 	u64 offset;
 	offset = sector * (s64)m_blocksize + m_dataoffset;
 
@@ -62,6 +213,13 @@ void FlatFileReader::BeginRead(void* pBuffer, uint sector, uint count)
 
 int FlatFileReader::FinishRead(void)
 {
+	if (m_mapped_pending) {
+		int res = m_mapped_result;
+		m_mapped_pending = false;
+		m_mapped_result = -1;
+		return res;
+	}
+
 	int min_nr = 1;
 	int max_nr = 1;
 	struct io_event events[max_nr];
@@ -84,6 +242,8 @@ void FlatFileReader::CancelRead(void)
 
 void FlatFileReader::Close(void)
 {
+	UnmapFile();
+	m_map_enabled = false;
 
 	if (m_fd != -1) close(m_fd);
 
@@ -49,6 +49,38 @@ extern bool renderswitch;
 std::list<uint> ringposStack;
 #endif
 
+// Adaptive wait limits, in SpinWait() iterations (see the ring protocol notes in GS.h).
+static const uint MTGS_SpinMin		= 64;
+static const uint MTGS_SpinMax		= 4096;
+static const uint MTGS_YieldCount	= 4;
+
+// Spins up to 'budget' times waiting for cond, then yields a few timeslices.  The budget
+// doubles when the spin succeeded and halves when it didn't.  Returns false if cond is
+// still false, in which case the caller has to block.
+template< typename Cond >
+static bool AdaptiveWait( uint& budget, const Cond& cond )
+{
+	for (uint i = 0; i < budget; ++i)
+	{
+		if (cond())
+		{
+			budget = std::min( budget * 2, MTGS_SpinMax );
+			return true;
+		}
+		SpinWait();
+	}
+
+	budget = std::max( budget / 2, MTGS_SpinMin );
+
+	for (uint i = 0; i < MTGS_YieldCount; ++i)
+	{
+		Timeslice();
+		if (cond()) return true;
+	}
+
+	return false;
+}
+
 SysMtgsThread::SysMtgsThread() :
 	SysThreadBase()
 #ifdef RINGBUF_DEBUG_STACK
@@ -70,6 +102,15 @@ void SysMtgsThread::OnStart()
 	m_packet_size		= 0;
 	m_packet_writepos	= 0;
 
+	m_EESpinBudget		= MTGS_SpinMin;
+	m_GSSpinBudget		= MTGS_SpinMin;
+	m_EEStallTicks		= 0;
+	m_EEStalls			= 0;
+	m_GSIdleTicks		= 0;
+	m_FrameEEStallTicks	= 0;
+	m_FrameEEStalls		= 0;
+	m_FrameGSIdleTicks	= 0;
+
 	m_QueuedFrameCount    = 0;
 	m_VsyncSignalListener = false;
 	m_SignalRingEnable    = false;
@@ -153,7 +194,13 @@ void SysMtgsThread::PostVsyncStart()
 	// If those are needed back, it's better to increase the VsyncQueueSize via PCSX_vm.ini.
 	// (The Xenosaga engine is known to run into this, due to it throwing bulks of data in one frame followed by 2 empty frames.)
 
-	if ((m_QueuedFrameCount.fetch_add(1) < EmuConfig.GS.VsyncQueueSize) /*|| (!EmuConfig.GS.VsyncEnable && !EmuConfig.GS.FrameLimitEnable)*/) return;
+	if ((m_QueuedFrameCount.fetch_add(1) < EmuConfig.GS.VsyncQueueSize) /*|| (!EmuConfig.GS.VsyncEnable && !EmuConfig.GS.FrameLimitEnable)*/)
+	{
+		LatchEEStalls();
+		return;
+	}
+
+	const u64 stallStart = GetCPUTicks();
 
 	m_VsyncSignalListener.store(true, std::memory_order_release);
 	//Console.WriteLn( Color_Blue, "(EEcore Sleep) Vsync\t\tringpos=0x%06x, writepos=0x%06x", m_ReadPos.load(), m_WritePos.load() );
@@ -165,6 +212,9 @@ void SysMtgsThread::PostVsyncStart()
 	m_sem_event.Post();
 
 	m_sem_Vsync.WaitNoCancel();
+
+	AddEEStall( stallStart );
+	LatchEEStalls();
 }
 
 union PacketTagType
@@ -285,11 +335,36 @@ void SysMtgsThread::ExecuteTaskInThread()
 	while(true) {
 		busy.Release();
 
-		// Performance note: Both of these perform cancellation tests, but pthread_testcancel
-		// is very optimized (only 1 instruction test in most cases), so no point in trying
-		// to avoid it.
+		// Wait for more data (see the ring protocol notes in GS.h).  The busy flag stays set
+		// while spinning so the EE doesn't bother posting, but the busy locks are released
+		// so WaitGS callers aren't held back by an idle MTGS.
+
+		const u64 idleStart = GetCPUTicks();
+		m_RingBufferIsBusy.store(true, std::memory_order_relaxed);
+
+		// The EE waiting on a signal also ends the spin, so the safety valves at the end of
+		// the loop get a chance to run.
+		const auto wakeup = [this]() {
+			return !IsRingEmpty()
+				|| m_SignalRingEnable.load(std::memory_order_relaxed)
+				|| m_VsyncSignalListener.load(std::memory_order_relaxed);
+		};
+
+		if (!AdaptiveWait( m_GSSpinBudget, wakeup ))
+		{
+			m_RingBufferIsBusy.store(false, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			// Performance note: Both of these perform cancellation tests, but pthread_testcancel
+			// is very optimized (only 1 instruction test in most cases), so no point in trying
+			// to avoid it.
+
+			if (!wakeup())
+				m_sem_event.WaitWithoutYield();
+		}
+
+		m_GSIdleTicks += GetCPUTicks() - idleStart;
 
-		m_sem_event.WaitWithoutYield();
 		StateCheckInThread();
 		busy.Acquire();
 
@@ -453,6 +528,9 @@ void SysMtgsThread::ExecuteTaskInThread()
 							if( (GSopen2 == NULL) && (PADupdate != NULL) )
 								PADupdate(0);
 
+							m_FrameGSIdleTicks.store(m_GSIdleTicks, std::memory_order_relaxed);
+							m_GSIdleTicks = 0;
+
 							m_QueuedFrameCount.fetch_sub(1);
 							if (m_VsyncSignalListener.exchange(false))
 								m_sem_Vsync.Post();
@@ -610,9 +688,16 @@ void SysMtgsThread::WaitGS(bool syncRegs, bool weakWait, bool isMTVU)
 	// we don't want to access the content of the queue
 
 	if (isMTVU || m_ReadPos.load(std::memory_order_relaxed) != m_WritePos.load(std::memory_order_relaxed)) {
+		const u64 stallStart = GetCPUTicks();
+
 		SetEvent();
 		RethrowException();
-		for(;;) {
+
+		// Full waits from the EE usually complete within microseconds, spin on those
+		// before blocking on the busy lock.
+		const bool spinDone = !isMTVU && !weakWait && AdaptiveWait( m_EESpinBudget, [this]() { return IsRingEmpty(); } );
+
+		for(;!spinDone;) {
 			if (weakWait) m_mtx_RingBufferBusy2.Wait();
 			else          m_mtx_RingBufferBusy .Wait();
 			RethrowException();
@@ -626,6 +711,8 @@ void SysMtgsThread::WaitGS(bool syncRegs, bool weakWait, bool isMTVU)
 			// code, so reading it from the MTVU thread might be dangerous;
 			// hence it has been avoided...
 		}
+
+		if (!isMTVU) AddEEStall( stallStart );
 	}
 
 	if (syncRegs) {
@@ -639,12 +726,45 @@ void SysMtgsThread::WaitGS(bool syncRegs, bool weakWait, bool isMTVU)
 // For use in loops that wait on the GS thread to do certain things.
 void SysMtgsThread::SetEvent()
 {
+	// Pairs with the fence taken by the MTGS before it goes to sleep.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
 	if(!m_RingBufferIsBusy.load(std::memory_order_relaxed))
 		m_sem_event.Post();
 
 	m_CopyDataTally = 0;
 }
 
+bool SysMtgsThread::IsRingEmpty() const
+{
+	return m_ReadPos.load(std::memory_order_acquire) == m_WritePos.load(std::memory_order_acquire);
+}
+
+void SysMtgsThread::AddEEStall( u64 startTicks )
+{
+	m_EEStallTicks.fetch_add(GetCPUTicks() - startTicks, std::memory_order_relaxed);
+	m_EEStalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Latches the EE stall counters of the frame that just ended. Called at the end of
+// PostVsyncStart, so the vsync queue wait is charged to the frame that caused it.
+void SysMtgsThread::LatchEEStalls()
+{
+	m_FrameEEStallTicks.store(m_EEStallTicks.exchange(0), std::memory_order_relaxed);
+	m_FrameEEStalls.store(m_EEStalls.exchange(0), std::memory_order_relaxed);
+}
+
+MTGS_StallStats SysMtgsThread::GetStallStats() const
+{
+	const double ticksToMs = 1000.0 / GetTickFrequency();
+
+	MTGS_StallStats stats;
+	stats.EEStallMs	= m_FrameEEStallTicks.load(std::memory_order_relaxed) * ticksToMs;
+	stats.EEStalls	= m_FrameEEStalls.load(std::memory_order_relaxed);
+	stats.GSIdleMs	= m_FrameGSIdleTicks.load(std::memory_order_relaxed) * ticksToMs;
+	return stats;
+}
+
 u8* SysMtgsThread::GetDataPacketPtr() const
 {
 	return (u8*)&RingBuffer[m_packet_writepos & RingBufferMask];
@@ -710,19 +830,32 @@ void SysMtgsThread::GenericStall( uint size )
 		// readpos is out past the end of the future write pos, or until it wraps around
 		// (in which case writepos will be >= readpos).
 
-		// Ideally though we want to wait longer, because if we just toss in this packet
-		// the next packet will likely stall up too.  So lets set a condition for the MTGS
-		// thread to wake up the EE once there's a sizable chunk of the ringbuffer emptied.
+		const u64 stallStart = GetCPUTicks();
+
+		// The MTGS is usually close behind, so spin on m_ReadPos first (FMVs in particular
+		// send very little data to the GS, sleeping the EEcore there is a waste of time).
 
-		uint somedone	= (RingBufferSize - freeroom) / 4;
-		if( somedone < size+1 ) somedone = size + 1;
+		SetEvent();
+		const bool spinDone = AdaptiveWait( m_EESpinBudget, [&]() {
+			readpos = m_ReadPos.load(std::memory_order_acquire);
+
+			if (writepos < readpos)
+				freeroom = readpos - writepos;
+			else
+				freeroom = RingBufferSize - (writepos - readpos);
 
-		// FMV Optimization: FMVs typically send *very* little data to the GS, in some cases
-		// every other frame is nothing more than a page swap.  Sleeping the EEcore is a
-		// waste of time, and we get better results using a spinwait.
+			return freeroom > size;
+		});
 
-		if( somedone > 0x80 )
+		if (!spinDone)
 		{
+			// Don't wake up as soon as the packet fits, because if we just toss in this packet
+			// the next packet will likely stall up too.  So lets set a condition for the MTGS
+			// thread to wake up the EE once there's a sizable chunk of the ringbuffer emptied.
+
+			uint somedone	= (RingBufferSize - freeroom) / 4;
+			if( somedone < size+1 ) somedone = size + 1;
+
 			pxAssertDev( m_SignalRingEnable == 0, "MTGS Thread Synchronization Error" );
 			m_SignalRingPosition.store(somedone, std::memory_order_release);
 
@@ -745,22 +878,8 @@ void SysMtgsThread::GenericStall( uint size )
 
 			pxAssertDev( m_SignalRingPosition <= 0, "MTGS Thread Synchronization Error" );
 		}
-		else
-		{
-			//Console.WriteLn( Color_StrongGray, "(EEcore Spin) PrepDataPacket!" );
-			SetEvent();
-			while(true) {
-				SpinWait();
-				readpos = m_ReadPos.load(std::memory_order_acquire);
 
-				if (writepos < readpos)
-					freeroom = readpos - writepos;
-				else
-					freeroom = RingBufferSize - (writepos - readpos);
-
-				if (freeroom > size) break;
-			}
-		}
+		AddEEStall( stallStart );
 	}
 }
 
@@ -852,6 +852,7 @@ void eeMemoryReserve::Reset()
 
 void eeMemoryReserve::Decommit()
 {
+	mmap_StopDirtyTracking();
 	_parent::Decommit();
 	eeMem = NULL;
 }
@@ -905,6 +906,12 @@ struct vtlb_PageProtectionInfo
 
 static __aligned16 vtlb_PageProtectionInfo m_PageProtectInfo[Ps2MemSize::MainRam >> 12];
 
+// Dirty page tracking, for incremental savestates.  While enabled every clean page is
+// write protected (on top of the recompiler protection above) and the first write to it
+// marks it dirty and lifts the protection.
+static bool m_DirtyTracking = false;
+static u8 m_PageDirty[Ps2MemSize::MainRam >> 12];
+
 
 // returns:
 //  ProtMode_NotRequired - unchecked block (resides in ROM, thus is integrity is constant)
@@ -981,10 +988,84 @@ void mmap_PageFaultHandler::OnPageFaultEvent( const PageFaultInfo& info, bool& h
 	uptr offset = info.addr - (uptr)eeMem->Main;
 	if( offset >= Ps2MemSize::MainRam ) return;
 
+	int rampage = offset >> 12;
+	if( m_DirtyTracking && !m_PageDirty[rampage] )
+	{
+		m_PageDirty[rampage] = 1;
+
+		// Only protected for the dirty tracking, no recompiled code to clear.
+		if( m_PageProtectInfo[rampage].Mode != ProtMode_Write )
+		{
+			HostSys::MemProtect( &eeMem->Main[rampage<<12], __pagesize, PageAccess_ReadWrite() );
+			handled = true;
+			return;
+		}
+	}
+
 	mmap_ClearCpuBlock( offset );
 	handled = true;
 }
 
+// Applies the dirty tracking write protection to all the clean pages.
+static void mmap_ProtectCleanPages()
+{
+	pxAssert( eeMem );
+
+	static const int PageCount = Ps2MemSize::MainRam >> 12;
+
+	// Coalesce runs of clean pages, the whole 32MB is usually clean.
+	for( int start = 0; start < PageCount; )
+	{
+		if( m_PageDirty[start] ) { ++start; continue; }
+
+		int end = start + 1;
+		while( end < PageCount && !m_PageDirty[end] ) ++end;
+
+		HostSys::MemProtect( &eeMem->Main[start<<12], (end - start) << 12, PageAccess_ReadOnly() );
+		start = end;
+	}
+}
+
+// Marks every EE RAM page as clean and starts tracking writes to them.  Subsequent calls
+// re-arm the tracking (typically right after taking a new base savestate).
+void mmap_StartDirtyTracking()
+{
+	pxAssert( eeMem );
+
+	memzero( m_PageDirty );
+	m_DirtyTracking = true;
+	mmap_ProtectCleanPages();
+}
+
+void mmap_StopDirtyTracking()
+{
+	if( !m_DirtyTracking ) return;
+	m_DirtyTracking = false;
+
+	if( !eeMem ) return;
+
+	// Keep the protection of the pages that hold recompiled code.
+	for( int rampage = 0; rampage < (Ps2MemSize::MainRam >> 12); ++rampage )
+	{
+		if( !m_PageDirty[rampage] && m_PageProtectInfo[rampage].Mode != ProtMode_Write )
+			HostSys::MemProtect( &eeMem->Main[rampage<<12], __pagesize, PageAccess_ReadWrite() );
+	}
+}
+
+bool mmap_IsDirtyTracking()
+{
+	return m_DirtyTracking;
+}
+
+// rampage - page index relative to eeMem->Main.
+// Returns true if the page was written since the tracking was (re)started, or if
+// there's no tracking at all.
+bool mmap_IsRamPageDirty( uint rampage )
+{
+	pxAssert( rampage < (Ps2MemSize::MainRam >> 12) );
+	return !m_DirtyTracking || m_PageDirty[rampage];
+}
+
 // Clears all block tracking statuses, manual protection flags, and write protection.
 // This does not clear any recompiler blocks.  It is assumed (and necessary) for the caller
 // to ensure the EErec is also reset in conjunction with calling this function.
@@ -994,4 +1075,7 @@ void mmap_ResetBlockTracking()
 	//DbgCon.WriteLn( "vtlb/mmap: Block Tracking reset..." );
 	memzero( m_PageProtectInfo );
 	if (eeMem) HostSys::MemProtect( eeMem->Main, Ps2MemSize::MainRam, PageAccess_ReadWrite() );
+
+	// The dirty tracking outlives recompiler resets (savestate loads reset the recs).
+	if (eeMem && m_DirtyTracking) mmap_ProtectCleanPages();
 }
@@ -241,3 +241,11 @@ void MultipartFileReader::SetBlockSize(uint bytes)
 	}
 }
 
+void MultipartFileReader::Prefetch(uint sector)
+{
+	if (sector >= GetBlockCount())
+		return;
+
+	uint i = GetFirstPart(sector);
+	m_parts[i].reader->Prefetch(sector - m_parts[i].start);
+}
@@ -50,6 +50,7 @@ Pcsx2Config::SpeedhackOptions& Pcsx2Config::SpeedhackOptions::DisableAll()
 	bitset			= 0;
 	EECycleRate		= 0;
 	VUCycleSteal	= 0;
+	IopCycleSkew	= 0;
 	
 	return *this;
 }
@@ -60,6 +61,7 @@ void Pcsx2Config::SpeedhackOptions::LoadSave( IniInterface& ini )
 
 	IniBitfield( EECycleRate );
 	IniBitfield( VUCycleSteal );
+	IniBitfield( IopCycleSkew );
 	IniBitBool( fastCDVD );
 	IniBitBool( IntcStat );
 	IniBitBool( WaitLoop );
@@ -89,6 +91,8 @@ Pcsx2Config::RecompilerOptions::RecompilerOptions()
 
 	EnableEE	= true;
 	EnableEECache = false;
+	EnableEETier2 = false;
+	EnableVUCache = false;
 	EnableIOP	= true;
 	EnableVU0	= true;
 	EnableVU1	= true;
@@ -147,6 +151,8 @@ void Pcsx2Config::RecompilerOptions::LoadSave( IniInterface& ini )
 	IniBitBool( EnableEE );
 	IniBitBool( EnableIOP );
 	IniBitBool( EnableEECache );
+	IniBitBool( EnableEETier2 );
+	IniBitBool( EnableVUCache );
 	IniBitBool( EnableVU0 );
 	IniBitBool( EnableVU1 );
 
@@ -386,6 +392,24 @@ void Pcsx2Config::GamefixOptions::LoadSave( IniInterface& ini )
 }
 
 
+Pcsx2Config::RewindOptions::RewindOptions()
+{
+	bitset			= 0;
+	IntervalVsyncs	= 120;
+	MemoryLimitMB	= 512;
+	DeltasPerBase	= 30;
+}
+
+void Pcsx2Config::RewindOptions::LoadSave( IniInterface& ini )
+{
+	ScopedIniGroup path( ini, L"Rewind" );
+
+	IniBitBool( Enabled );
+	IniEntry( IntervalVsyncs );
+	IniEntry( MemoryLimitMB );
+	IniEntry( DeltasPerBase );
+}
+
 Pcsx2Config::DebugOptions::DebugOptions()
 {
 	ShowDebuggerOnStart = false;
@@ -430,6 +454,7 @@ void Pcsx2Config::LoadSave( IniInterface& ini )
 	IniBitBool( CdvdVerboseReads );
 	IniBitBool( CdvdDumpBlocks );
 	IniBitBool( CdvdShareWrite );
+	IniBitBool( CdvdMapIsoFile );
 	IniBitBool( EnablePatches );
 	IniBitBool( EnableCheats );
 	IniBitBool( EnableWideScreenPatches );
@@ -449,6 +474,7 @@ void Pcsx2Config::LoadSave( IniInterface& ini )
 	GS				.LoadSave( ini );
 	Gamefixes		.LoadSave( ini );
 	Profiler		.LoadSave( ini );
+	Rewind			.LoadSave( ini );
 
 	Debugger		.LoadSave( ini );
 	Trace			.LoadSave( ini );
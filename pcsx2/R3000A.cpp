@@ -48,6 +48,8 @@ bool iopEventAction = false;
 
 bool iopEventTestIsActive = false;
 
+IopSyncStats iopSyncStats;
+
 __aligned16 psxRegisters psxRegs;
 
 void psxReset()
@@ -62,6 +64,9 @@ void psxReset()
 	iopCycleEE = -1;
 	g_iopNextEventCycle = psxRegs.cycle + 4;
 
+	if( EmuConfig.Speedhacks.IopCycleSkew ) iopPrintSyncStats();
+	memzero( iopSyncStats );
+
 	psxHwReset();
 
 	ioman::reset();
@@ -226,6 +231,40 @@ __ri void iopEventTest()
 	}
 }
 
+// Makes the EE branch shortly so the IOP catches up with it.  IOP interrupts always do, the
+// other syncs are only needed when the IOP is allowed to lag behind the EE.
+void iopSyncWithEE( IopSyncReason reason )
+{
+	if( reason != IopSync_Intc && !EmuConfig.Speedhacks.IopCycleSkew ) return;
+
+	iopSyncStats.syncs[reason]++;
+
+	const s32 behind = EEsCycle + (s32)(cpuRegs.cycle - EEoCycle);
+	if( behind > 0 )
+	{
+		iopSyncStats.waits++;
+		iopSyncStats.waitCycles += behind;
+	}
+
+	cpuSetNextEventDelta( 16 );
+	iopEventAction = true;
+}
+
+void iopPrintSyncStats()
+{
+	const IopSyncStats& s = iopSyncStats;
+
+	if( s.slices )
+	{
+		DevCon.WriteLn( "IOP sync: %u slices, syncs: %u SIF regs, %u SIF DMAs, %u interrupts; EE waited %u times (avg %u cycles behind)",
+			s.slices, s.syncs[IopSync_SifReg], s.syncs[IopSync_SifDma], s.syncs[IopSync_Intc],
+			s.waits, s.waits ? (u32)(s.waitCycles / s.waits) : 0 );
+	}
+
+	memzero( iopSyncStats );
+	iopSyncStats.cycle = cpuRegs.cycle;
+}
+
 void iopTestIntc()
 {
 	if( psxHu32(0x1078) == 0 ) return;
@@ -236,8 +275,7 @@ void iopTestIntc()
 		// An iop exception has occurred while the EE is running code.
 		// Inform the EE to branch so the IOP can handle it promptly:
 
-		cpuSetNextEventDelta( 16 );
-		iopEventAction = true;
+		iopSyncWithEE( IopSync_Intc );
 		//Console.Error( "** IOP Needs an EE EventText, kthx **  %d", iopCycleEE );
 
 		// Note: No need to set the iop's branch delta here, since the EE
@@ -178,6 +178,36 @@ extern bool iopEventTestIsActive;
 // Branching status used when throwing exceptions.
 extern bool iopIsDelaySlot;
 
+// --------------------------------------------------------------------------------------
+//  EE/IOP synchronization
+// --------------------------------------------------------------------------------------
+// With Speedhacks.IopCycleSkew the IOP is only run once the EE is that many cycles ahead of
+// it, so it executes fewer and longer slices.  Whenever the EE touches state it shares with
+// the IOP, it syncs: the IOP catches up at the next EE event test.
+
+enum IopSyncReason
+{
+	IopSync_SifReg,		// EE read or wrote a SIF register
+	IopSync_SifDma,		// EE started a SIF DMA
+	IopSync_Intc,		// IOP interrupt raised while the EE runs code
+
+	IopSync_ReasonCount
+};
+
+struct IopSyncStats
+{
+	u32 cycle;			// EE cycle of the last report
+	u32 slices;			// IOP ExecuteBlock calls
+	u32 syncs[IopSync_ReasonCount];
+	u32 waits;			// syncs for which the IOP was behind (the EE waits for it to catch up)
+	u64 waitCycles;		// EE cycles the IOP was behind at those syncs
+};
+
+extern IopSyncStats iopSyncStats;
+
+extern void iopSyncWithEE( IopSyncReason reason );
+extern void iopPrintSyncStats();
+
 // --------------------------------------------------------------------------------------
 //  R3000Acpu
 // --------------------------------------------------------------------------------------
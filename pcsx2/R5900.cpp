@@ -395,11 +395,16 @@ __fi void _cpuEventTest_Shared()
 	//
 	// * The IOP cannot always be run.  If we run IOP code every time through the
 	//   cpuEventTest, the IOP generally starts to run way ahead of the EE.
+	//
+	// * With IopCycleSkew the EE can run that far ahead before the IOP catches up,
+	//   unless the EE synced with it (see iopSyncWithEE).
+
+	const s32 iopSkew = EmuConfig.Speedhacks.IopCycleSkew;
 
 	EEsCycle += cpuRegs.cycle - EEoCycle;
 	EEoCycle = cpuRegs.cycle;
 
-	if( EEsCycle > 0 )
+	if( EEsCycle > iopSkew )
 		iopEventAction = true;
 
 	iopEventTest();
@@ -412,8 +417,12 @@ __fi void _cpuEventTest_Shared()
 		EEsCycle = psxCpu->ExecuteBlock( EEsCycle );
 
 		iopEventAction = false;
+		iopSyncStats.slices++;
 	}
 
+	if( iopSkew && (cpuRegs.cycle - iopSyncStats.cycle) >= PS2CLK * 10 )
+		iopPrintSyncStats();
+
 	// ---- VU0 -------------
 	// We're in a EventTest.  All dynarec registers are flushed
 	// so there is no need to freeze registers here.
@@ -425,7 +434,7 @@ __fi void _cpuEventTest_Shared()
 
 	// ---- Schedule Next Event Test --------------
 
-	if( EEsCycle > 192 )
+	if( EEsCycle > 192 + iopSkew )
 	{
 		// EE's running way ahead of the IOP still, so we should branch quickly to give the
 		// IOP extra timeslices in short order.
@@ -435,8 +444,8 @@ __fi void _cpuEventTest_Shared()
 	}
 
 	// The IOP could be running ahead/behind of us, so adjust the iop's next branch by its
-	// relative position to the EE (via EEsCycle)
-	cpuSetNextEventDelta( ((g_iopNextEventCycle-psxRegs.cycle)*8) - EEsCycle );
+	// relative position to the EE (via EEsCycle), and let it lag behind by the allowed skew
+	cpuSetNextEventDelta( ((g_iopNextEventCycle-psxRegs.cycle)*8) - EEsCycle + iopSkew );
 
 	// Apply the hsync counter's nextCycle
 	cpuSetNextEvent( hsyncCounter.sCycle, hsyncCounter.CycleT );
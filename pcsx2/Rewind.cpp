@@ -0,0 +1,396 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2017  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "Common.h"
+#include "SaveState.h"
+#include "Rewind.h"
+
+#include "Utilities/SafeArray.inl"
+
+#ifdef __POSIX__
+#include <zlib.h>
+#else
+#include <zlib/zlib.h>
+#endif
+
+static RewindBuffer s_rewind;
+
+RewindBuffer& GetRewindBuffer()
+{
+	return s_rewind;
+}
+
+static __fi u64 TicksToUs( u64 ticks )
+{
+	return ticks * 1000000 / GetTickFrequency();
+}
+
+RewindBuffer::RewindBuffer()
+	: m_busy( false )
+{
+	m_name = L"Rewind";
+
+	m_baseInHistory	= false;
+	m_deltas		= 0;
+	m_pendingSize	= 0;
+	m_pendingBase	= false;
+	m_vsyncs		= 0;
+	m_historyBytes	= 0;
+	memzero( m_stats );
+}
+
+RewindBuffer::~RewindBuffer()
+{
+	try {
+		_parent::Cancel();
+	}
+	DESTRUCTOR_CATCHALL
+}
+
+bool RewindBuffer::Vsync()
+{
+	if (!EmuConfig.Rewind.Enabled)
+	{
+		m_vsyncs = 0;
+		return false;
+	}
+
+	if (++m_vsyncs < (uint)std::max( 1, EmuConfig.Rewind.IntervalVsyncs )) return false;
+
+	m_vsyncs = 0;
+	return true;
+}
+
+// Must be called with m_lock held.
+std::unique_ptr<VmStateBuffer> RewindBuffer::GetBuffer()
+{
+	if (m_spare) return std::move(m_spare);
+	return std::unique_ptr<VmStateBuffer>(new VmStateBuffer( L"Rewind Snapshot" ));
+}
+
+// Must be called with m_lock held.
+u64 RewindBuffer::GetMemoryUsed() const
+{
+	return m_historyBytes + (m_base ? m_base->GetSizeInBytes() : 0) + (m_pending ? m_pendingSize : 0);
+}
+
+// Must be called with m_lock held, and the core thread paused (or from the core thread).
+// Stops the EE RAM dirty tracking, the next snapshot will be a new base.
+void RewindBuffer::ReleaseBase()
+{
+	memDeltaSavingState::ReleaseBase();
+
+	m_base.reset();
+	m_baseInHistory	= false;
+	m_deltas		= 0;
+}
+
+// Core thread only, at a point where regular savestates can be taken.
+void RewindBuffer::Capture()
+{
+	if (m_busy)
+	{
+		// Never stall the core thread on the compressor, just try again next time.
+		ScopedLock lock( m_lock );
+		++m_stats.skipped;
+		return;
+	}
+
+	const u64 start = GetCPUTicks();
+	const bool isBase = !m_base || !m_baseInHistory || (m_deltas >= (uint)std::max( 0, EmuConfig.Rewind.DeltasPerBase ));
+
+	std::unique_ptr<VmStateBuffer> snapshot;
+	uint size = 0;
+
+	try {
+		if (isBase)
+		{
+			// The previous base is already compressed in the history, its buffer is reused.
+			// FreezeBase also restarts the dirty tracking against the new base.
+			if (!m_base) m_base.reset( new VmStateBuffer( L"Rewind Base" ) );
+			m_baseInHistory = false;
+
+			memDeltaSavingState::FreezeBase( *m_base );
+			size = m_base->GetSizeInBytes();
+		}
+		else
+		{
+			{
+				ScopedLock lock( m_lock );
+				snapshot = GetBuffer();
+			}
+
+			memDeltaSavingState saver( *snapshot, *m_base );
+			saver.FreezeAll();
+			size = saver.GetCurrentPos();
+		}
+	}
+	catch( BaseException& ex )
+	{
+		Console.Error( L"Rewind: snapshot failed: %s", WX_STR(ex.FormatDiagnosticMessage()) );
+		ScopedLock lock( m_lock );
+		if (snapshot) m_spare = std::move(snapshot);
+		if (isBase) ReleaseBase();
+		return;
+	}
+
+#ifdef PCSX2_DEVBUILD
+	// Round-trip check: the delta must give back the memory it was just saved from.
+	if (!isBase && !memDeltaLoadingState::MatchesMainMemory( *snapshot, *m_base ))
+	{
+		Console.Error( "Rewind: incremental snapshot doesn't match the VM memory, starting a new base." );
+		ScopedLock lock( m_lock );
+		m_spare = std::move(snapshot);
+		ReleaseBase();
+		return;
+	}
+#endif
+
+	ScopedLock lock( m_lock );
+
+	if (isBase)
+	{
+		m_deltas		= 0;
+		m_pendingBase	= true;
+	}
+	else
+	{
+		++m_deltas;
+		m_pending		= std::move(snapshot);
+		m_pendingSize	= size;
+	}
+
+	m_stats.lastCaptureBytes	= size;
+	m_stats.lastCaptureUs		= TicksToUs( GetCPUTicks() - start );
+	m_stats.maxCaptureUs		= std::max( m_stats.maxCaptureUs, m_stats.lastCaptureUs );
+
+	m_busy = true;
+	if (!IsRunning()) Start();
+	m_sem_event.Post();
+
+	EnforceLimit();
+}
+
+// Must be called with m_lock held.
+bool RewindBuffer::Decompress( const Entry& entry, VmStateBuffer& dest )
+{
+	// Exact size: deltas check the size of their base.
+	dest.ExactAlloc( entry.size );
+
+	uLongf length = entry.size;
+	return (uncompress( dest.GetPtr(), &length, entry.data.data(), entry.data.size() ) == Z_OK) && (length == entry.size);
+}
+
+// Loads the newest snapshot into the VM and removes it from the history.  Like any state
+// load, the core thread must be paused and the execution cache cleared.  Returns false if
+// the history is empty.
+bool RewindBuffer::Load()
+{
+	WaitIdle();
+
+	std::unique_ptr<VmStateBuffer> base;
+	std::unique_ptr<VmStateBuffer> delta;
+	bool isBase;
+
+	{
+		ScopedLock lock( m_lock );
+		if (m_history.empty()) return false;
+
+		size_t baseIdx = m_history.size() - 1;
+		while (baseIdx > 0 && !m_history[baseIdx].isBase) --baseIdx;
+		isBase = (baseIdx == m_history.size() - 1);
+
+		// The current base doesn't need to be decompressed.
+		const bool currentBase = m_base && m_baseInHistory;
+
+		bool valid = m_history[baseIdx].isBase;
+		if (valid && !currentBase)
+		{
+			base = GetBuffer();
+			valid = Decompress( m_history[baseIdx], *base );
+		}
+		if (valid && !isBase)
+		{
+			delta = GetBuffer();
+			valid = Decompress( m_history.back(), *delta );
+		}
+
+		if (!valid)
+		{
+			Console.Error( "Rewind: snapshot data is corrupted, discarding the history." );
+			m_history.clear();
+			m_historyBytes = 0;
+			ReleaseBase();
+			return false;
+		}
+
+		m_historyBytes -= m_history.back().data.size();
+		m_history.pop_back();
+
+		if (isBase)
+		{
+			// The base leaves the history, the next snapshot will be a new one.
+			if (!base) base = std::move(m_base);
+			ReleaseBase();
+		}
+	}
+
+	const VmStateBuffer& loadBase = base ? *base : *m_base;
+
+	if (isBase)
+		memLoadingState( loadBase ).FreezeAll();
+	else
+		memDeltaLoadingState( *delta, loadBase ).FreezeAll();
+
+	ScopedLock lock( m_lock );
+	if (!m_spare) m_spare = std::move(delta);
+
+	return true;
+}
+
+void RewindBuffer::Clear()
+{
+	WaitIdle();
+	PrintStats();
+
+	ScopedLock lock( m_lock );
+
+	m_history.clear();
+	ReleaseBase();
+	m_pending.reset();
+	m_spare.reset();
+	std::vector<u8>().swap( m_scratch );
+
+	m_pendingSize	= 0;
+	m_pendingBase	= false;
+	m_vsyncs		= 0;
+	m_historyBytes	= 0;
+	memzero( m_stats );
+}
+
+RewindBuffer::Stats RewindBuffer::GetStats()
+{
+	ScopedLock lock( m_lock );
+
+	Stats stats = m_stats;
+	stats.snapshots		= m_history.size() + ((m_pending || m_pendingBase) ? 1 : 0);
+	stats.bases			= (uint)std::count_if( m_history.begin(), m_history.end(), []( const Entry& entry ) { return entry.isBase; } )
+						+ (m_pendingBase ? 1 : 0);
+	stats.memoryUsed	= GetMemoryUsed();
+	stats.memoryLimit	= (u64)EmuConfig.Rewind.MemoryLimitMB * _1mb;
+	return stats;
+}
+
+void RewindBuffer::PrintStats()
+{
+	const Stats stats = GetStats();
+	if (!stats.snapshots) return;
+
+	Console.WriteLn( Color_Gray, "Rewind: %u snapshots (%u full), %u MB used (limit %u MB), ratio %.1f:1",
+		stats.snapshots, stats.bases, (uint)(stats.memoryUsed / _1mb), (uint)(stats.memoryLimit / _1mb),
+		stats.compressedBytes ? (double)stats.rawBytes / stats.compressedBytes : 0.0 );
+	Console.WriteLn( Color_Gray, "Rewind: capture %u us (max %u us, %u KB), compress %u us, %u skipped, %u dropped",
+		(uint)stats.lastCaptureUs, (uint)stats.maxCaptureUs, (uint)(stats.lastCaptureBytes / 1024),
+		(uint)stats.lastCompressUs, stats.skipped, stats.dropped );
+}
+
+void RewindBuffer::WaitIdle()
+{
+	while (m_busy)
+		m_sem_done.WaitWithoutYield();
+}
+
+// Must be called with m_lock held.  Drops the oldest groups (a base and its deltas) while
+// the history is above the limit.  The newest group is always kept, even if it's above the
+// limit by itself.
+void RewindBuffer::EnforceLimit()
+{
+	const u64 limit = (u64)std::max( 1, EmuConfig.Rewind.MemoryLimitMB ) * _1mb;
+
+	while (GetMemoryUsed() > limit)
+	{
+		size_t next = 1;
+		while (next < m_history.size() && !m_history[next].isBase) ++next;
+		if (next >= m_history.size()) break;
+
+		for (size_t i = 0; i < next; ++i)
+			m_historyBytes -= m_history[i].data.size();
+
+		m_history.erase( m_history.begin(), m_history.begin() + next );
+		m_stats.dropped += (uint)next;
+	}
+}
+
+// Runs on the rewind thread.  The pending snapshot and m_base can't change while m_busy is
+// set: Capture() skips, Load() and Clear() wait.
+void RewindBuffer::CompressPending()
+{
+	const u64 start = GetCPUTicks();
+
+	const u8* src	= m_pendingBase ? m_base->GetPtr() : m_pending->GetPtr();
+	const uint size	= m_pendingBase ? m_base->GetSizeInBytes() : m_pendingSize;
+
+	uLongf length = compressBound( size );
+	if (m_scratch.size() < length) m_scratch.resize( length );
+
+	const int err = compress2( m_scratch.data(), &length, src, size, Z_BEST_SPEED );
+
+	Entry entry;
+	entry.size		= size;
+	entry.isBase	= m_pendingBase;
+	if (err == Z_OK) entry.data.assign( m_scratch.begin(), m_scratch.begin() + length );
+
+	ScopedLock lock( m_lock );
+
+	if (err == Z_OK)
+	{
+		m_historyBytes += entry.data.size();
+		m_stats.rawBytes += entry.size;
+		m_stats.compressedBytes += entry.data.size();
+		m_history.push_back( std::move(entry) );
+
+		if (m_pendingBase) m_baseInHistory = true;
+	}
+	else
+	{
+		// A lost delta is only a gap in the history.  A lost base leaves m_baseInHistory
+		// cleared, so the next snapshot will be a new base.
+		Console.Error( "Rewind: failed to compress a snapshot (zlib error %d), dropping it.", err );
+	}
+
+	if (!m_spare) m_spare = std::move(m_pending);
+	m_pending.reset();
+	m_pendingSize = 0;
+	m_pendingBase = false;
+
+	m_stats.lastCompressUs = TicksToUs( GetCPUTicks() - start );
+
+	EnforceLimit();
+}
+
+void RewindBuffer::ExecuteTaskInThread()
+{
+	while (true)
+	{
+		m_sem_event.WaitWithoutYield();
+		if (!m_busy) continue;
+
+		CompressPending();
+
+		m_busy = false;
+		m_sem_done.Post();
+	}
+}
@@ -0,0 +1,115 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2017  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "System.h"
+#include "Utilities/PersistentThread.h"
+
+using namespace Threading;
+
+// --------------------------------------------------------------------------------------
+//  RewindBuffer
+// --------------------------------------------------------------------------------------
+// In-memory rewind history.  Every EmuConfig.Rewind.IntervalVsyncs the core thread saves
+// a snapshot (see SysCoreThread::StateCheckInThread).  Snapshots are grouped: the first
+// one of a group is a full state (the base), the next DeltasPerBase ones are incremental
+// states against it (memDeltaSavingState), which only hold the memory pages written since
+// the base thanks to the EE RAM dirty tracking.  Every snapshot is deflated by this thread,
+// and the newest base is also kept as is, to capture the next deltas against it.  The
+// oldest groups are dropped to honour the memory cap.
+//
+// Capture() is only called from the core thread, Load() and Clear() only while the core
+// thread is paused (or from the core thread itself).
+class RewindBuffer : public pxThread
+{
+	typedef pxThread _parent;
+
+public:
+	struct Stats
+	{
+		uint	snapshots;		// snapshots available
+		uint	bases;			// full snapshots among them
+		uint	skipped;		// captures skipped because the previous one was still compressing
+		uint	dropped;		// oldest snapshots dropped to stay below the memory cap
+		u64		memoryUsed;		// compressed history + the current base, in bytes
+		u64		memoryLimit;
+		u64		lastCaptureUs;	// time the core thread spent in the last capture
+		u64		maxCaptureUs;
+		u64		lastCaptureBytes;	// uncompressed size of the last snapshot (full or incremental)
+		u64		lastCompressUs;	// time the compression thread spent on the last snapshot
+		u64		rawBytes;		// uncompressed size of the stored history
+		u64		compressedBytes;
+	};
+
+protected:
+	struct Entry
+	{
+		std::vector<u8>	data;	// deflated snapshot
+		uint			size;	// size of the snapshot
+		bool			isBase;	// full snapshot, the following ones are deltas against it
+	};
+
+	Mutex							m_lock;			// protects the history and the stats
+	Semaphore						m_sem_done;
+	std::atomic<bool>				m_busy;			// a snapshot is queued or being compressed
+
+	std::deque<Entry>				m_history;		// oldest first, always starts with a base
+	std::unique_ptr<VmStateBuffer>	m_base;			// newest base, deltas are captured against it
+	bool							m_baseInHistory;	// m_base is the last base of the history
+	uint							m_deltas;		// deltas captured against m_base
+
+	std::unique_ptr<VmStateBuffer>	m_pending;		// delta waiting to be compressed
+	uint							m_pendingSize;
+	bool							m_pendingBase;	// m_base is waiting to be compressed
+	std::unique_ptr<VmStateBuffer>	m_spare;		// recycled snapshot buffer, saves a big alloc per capture
+	std::vector<u8>					m_scratch;		// compression output
+
+	uint							m_vsyncs;
+	u64								m_historyBytes;
+	Stats							m_stats;
+
+public:
+	RewindBuffer();
+	virtual ~RewindBuffer();
+
+	// Counts vsyncs and returns true when a snapshot is due.
+	bool Vsync();
+
+	void Capture();
+	bool Load();
+	void Clear();
+
+	Stats GetStats();
+	void PrintStats();
+
+protected:
+	void WaitIdle();
+	void ReleaseBase();
+	bool Decompress( const Entry& entry, VmStateBuffer& dest );
+	void CompressPending();
+	void EnforceLimit();
+	u64 GetMemoryUsed() const;
+	std::unique_ptr<VmStateBuffer> GetBuffer();
+
+	void ExecuteTaskInThread();
+};
+
+extern RewindBuffer& GetRewindBuffer();
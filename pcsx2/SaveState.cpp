@@ -150,6 +150,37 @@ static const uint MainMemorySizeInBytes =
 	Ps2MemSize::MainRam	+ Ps2MemSize::Scratch		+ Ps2MemSize::Hardware +
 	Ps2MemSize::IopRam	+ Ps2MemSize::IopHardware;
 
+struct MainMemoryBlock
+{
+	u8*		ptr;
+	uint	size;
+};
+
+static const uint MainMemoryBlockCount = 9;
+
+// The blocks of the first savestate section, in savestate order.  The EE main memory
+// must stay first, incremental states rely on it (see FreezeMainMemoryDelta).
+static void GetMainMemoryBlocks( MainMemoryBlock (&blocks)[MainMemoryBlockCount] )
+{
+	const MainMemoryBlock list[MainMemoryBlockCount] =
+	{
+		{ eeMem->Main,		Ps2MemSize::MainRam },		// 32 MB main memory
+		{ eeMem->Scratch,	Ps2MemSize::Scratch },		// scratch pad
+		{ eeHw,				Ps2MemSize::Hardware },		// hardware memory
+
+		{ iopMem->Main,		Ps2MemSize::IopRam },		// 2 MB main memory
+		{ iopHw,			Ps2MemSize::IopHardware },	// hardware memory
+
+		{ vuRegs[0].Micro,	VU0_PROGSIZE },
+		{ vuRegs[0].Mem,	VU0_MEMSIZE },
+
+		{ vuRegs[1].Micro,	VU1_PROGSIZE },
+		{ vuRegs[1].Mem,	VU1_MEMSIZE },
+	};
+
+	memcpy( blocks, list, sizeof(list) );
+}
+
 SaveStateBase& SaveStateBase::FreezeMainMemory()
 {
 	vu1Thread.WaitVU(); // Finish VU1 just in-case...
@@ -158,19 +189,133 @@ SaveStateBase& SaveStateBase::FreezeMainMemory()
 
 	// First Block - Memory Dumps
 	// ---------------------------
-	FreezeMem(eeMem->Main,		Ps2MemSize::MainRam);		// 32 MB main memory
-	FreezeMem(eeMem->Scratch,	Ps2MemSize::Scratch);		// scratch pad
-	FreezeMem(eeHw,				Ps2MemSize::Hardware);		// hardware memory
+	MainMemoryBlock blocks[MainMemoryBlockCount];
+	GetMainMemoryBlocks( blocks );
 
-	FreezeMem(iopMem->Main, 	Ps2MemSize::IopRam);		// 2 MB main memory
-	FreezeMem(iopHw,			Ps2MemSize::IopHardware);	// hardware memory
-	
-	FreezeMem(vuRegs[0].Micro,	VU0_PROGSIZE);
-	FreezeMem(vuRegs[0].Mem,	VU0_MEMSIZE);
+	for (uint i=0; i<MainMemoryBlockCount; ++i)
+		FreezeMem( blocks[i].ptr, blocks[i].size );
+
+	return *this;
+}
+
+// Reads the main memory section of an incremental state (see FreezeMainMemoryDelta).  For
+// each block, fromBase(dest, src, size) is called for the runs of pages the delta doesn't
+// store, and fromDelta(dest, size) for each page it stores, with the state positioned on
+// the page data.
+template< typename FromBase, typename FromDelta >
+static void ReadMainMemoryDelta( SaveStateBase& state, const VmStateBuffer& base, const FromBase& fromBase, const FromDelta& fromDelta )
+{
+	state.FreezeTag( "DeltaMemory" );
+
+	u32 baseSize;
+	state.Freeze( baseSize );
+	if (baseSize != (u32)base.GetSizeInBytes())
+		throw Exception::SaveStateLoadError().SetDiagMsg(L"Incremental savestate doesn't match its base state.");
+
+	MainMemoryBlock blocks[MainMemoryBlockCount];
+	GetMainMemoryBlocks( blocks );
+
+	uint baseOffset = 0;
+	for (uint i=0; i<MainMemoryBlockCount; ++i)
+	{
+		u8* const data = blocks[i].ptr;
+		const uint size = blocks[i].size;
+		if (baseOffset + size > baseSize)
+			throw Exception::SaveStateLoadError().SetDiagMsg(L"Incremental savestate base is too small.");
+
+		const u8* const basedata = base.GetPtr( baseOffset );
+		baseOffset += size;
+
+		const u32 pages = (size + __pagesize - 1) / __pagesize;
+		u32 count;
+		state.Freeze( count );
+
+		// Pages are stored in ascending order; next is the first one not restored yet.
+		u32 next = 0;
+		for (u32 n=0; n<count; ++n)
+		{
+			u32 page;
+			state.Freeze( page );
+			if (page >= pages || page < next)
+				throw Exception::SaveStateLoadError().SetDiagMsg(L"Incremental savestate data is corrupted.");
+
+			const uint offset = page * __pagesize;
+			if (page > next)
+				fromBase( data + next * __pagesize, basedata + next * __pagesize, offset - next * __pagesize );
+			fromDelta( data + offset, std::min<uint>( __pagesize, size - offset ) );
+			next = page + 1;
+		}
+
+		if (next < pages)
+			fromBase( data + next * __pagesize, basedata + next * __pagesize, size - next * __pagesize );
+	}
+}
+
+// Incremental version of FreezeMainMemory: only the 4k pages which differ from the base
+// state are stored, each block as a page count followed by (index, data) pairs.
+//
+// EE main memory pages are selected by the vtlb dirty tracking when it was started along
+// with this base (see memDeltaSavingState::FreezeBase), the other blocks are small enough
+// to be compared against the base directly.  Loading takes the pages the delta doesn't
+// store from the base, so the base must be the one the delta was saved from.
+SaveStateBase& SaveStateBase::FreezeMainMemoryDelta( const VmStateBuffer& base, bool useDirtyTracking )
+{
+	vu1Thread.WaitVU(); // Finish VU1 just in-case...
+
+	if (IsLoading())
+	{
+		PreLoadPrep();
+		ReadMainMemoryDelta( *this, base,
+			[]( u8* dest, const u8* src, uint size ) { memcpy( dest, src, size ); },
+			[this]( u8* dest, uint size ) { FreezeMem( dest, size ); } );
+		return *this;
+	}
+
+	FreezeTag( "DeltaMemory" );
+
+	u32 baseSize = base.GetSizeInBytes();
+	Freeze( baseSize );
+
+	MainMemoryBlock blocks[MainMemoryBlockCount];
+	GetMainMemoryBlocks( blocks );
+
+	uint baseOffset = 0;
+	for (uint i=0; i<MainMemoryBlockCount; ++i)
+	{
+		u8* const data = blocks[i].ptr;
+		const uint size = blocks[i].size;
+		if (baseOffset + size > baseSize)
+			throw Exception::SaveStateLoadError().SetDiagMsg(L"Incremental savestate base is too small.");
+
+		const u8* const basedata = base.GetPtr( baseOffset );
+		baseOffset += size;
+
+		const u32 pages = (size + __pagesize - 1) / __pagesize;
+
+		// Count slot, filled once the pages are known.
+		const int countPos = m_idx;
+		u32 count = 0;
+		Freeze( count );
+
+		for (u32 page=0; page<pages; ++page)
+		{
+			const uint offset = page * __pagesize;
+			const int length = std::min<uint>( __pagesize, size - offset );
+
+			if (i == 0 && useDirtyTracking)
+			{
+				if (!mmap_IsRamPageDirty( page )) continue;
+			}
+			if (memcmp( data + offset, basedata + offset, length ) == 0) continue;
+
+			Freeze( page );
+			FreezeMem( data + offset, length );
+			++count;
+		}
+
+		memcpy( m_memory->GetPtr( countPos ), &count, sizeof(count) );
+	}
 
-	FreezeMem(vuRegs[1].Micro,	VU1_PROGSIZE);
-	FreezeMem(vuRegs[1].Mem,	VU1_MEMSIZE);
-	
 	return *this;
 }
 
@@ -302,6 +447,88 @@ memSavingState& memSavingState::FreezeAll()
 	return *this;
 }
 
+// --------------------------------------------------------------------------------------
+//  memDeltaSavingState / memDeltaLoadingState  (implementations)
+// --------------------------------------------------------------------------------------
+// Base whose pages are currently followed by the vtlb dirty tracking, if any.
+static const VmStateBuffer* s_DirtyTrackingBase = NULL;
+
+memDeltaSavingState::memDeltaSavingState( VmStateBuffer& save_to, const VmStateBuffer& base )
+	: memSavingState( save_to )
+	, m_base( base )
+{
+}
+
+// Saves a full state in base, and (re)starts the EE memory dirty tracking relative to it.
+// Must be called while the VM is suspended, like any other state save.
+void memDeltaSavingState::FreezeBase( VmStateBuffer& base )
+{
+	memSavingState saver( base );
+	saver.FreezeAll();
+
+	// Deltas identify their base by its size: trim the buffer to the state itself, so that
+	// any copy of the base (a decompressed one for instance) matches it.
+	base.ExactAlloc( saver.GetCurrentPos() );
+
+	mmap_StartDirtyTracking();
+	s_DirtyTrackingBase = &base;
+}
+
+// Stops the dirty tracking.  Deltas against the previous base remain valid, they just
+// fall back to comparing the whole memory.
+void memDeltaSavingState::ReleaseBase()
+{
+	mmap_StopDirtyTracking();
+	s_DirtyTrackingBase = NULL;
+}
+
+SaveStateBase& memDeltaSavingState::FreezeMainMemory()
+{
+	const bool tracked = mmap_IsDirtyTracking() && (s_DirtyTrackingBase == &m_base);
+	return FreezeMainMemoryDelta( m_base, tracked );
+}
+
+memDeltaLoadingState::memDeltaLoadingState( const VmStateBuffer& load_from, const VmStateBuffer& base )
+	: memLoadingState( load_from )
+	, m_base( base )
+{
+}
+
+SaveStateBase& memDeltaLoadingState::FreezeMainMemory()
+{
+	return FreezeMainMemoryDelta( m_base, false );
+}
+
+// Round-trip check of an incremental state: decodes the main memory of delta over base and
+// compares it with the current VM memory, without changing anything.  Returns true if
+// loading the delta would give back the memory it was saved from (call it before the VM
+// runs again).
+bool memDeltaLoadingState::MatchesMainMemory( const VmStateBuffer& delta, const VmStateBuffer& base )
+{
+	vu1Thread.WaitVU();
+
+	memLoadingState reader( delta );
+	u8 page[__pagesize];
+	bool match = true;
+
+	try {
+		ReadMainMemoryDelta( reader, base,
+			[&]( u8* dest, const u8* src, uint size ) {
+				match = match && (memcmp( dest, src, size ) == 0);
+			},
+			[&]( u8* dest, uint size ) {
+				reader.FreezeMem( page, size );
+				match = match && (memcmp( dest, page, size ) == 0);
+			} );
+	}
+	catch( Exception::SaveStateLoadError& )
+	{
+		return false;
+	}
+
+	return match;
+}
+
 // --------------------------------------------------------------------------------------
 //  memLoadingState  (implementations)
 // --------------------------------------------------------------------------------------
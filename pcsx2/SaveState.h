@@ -24,7 +24,7 @@
 //  the lower 16 bit value.  IF the change is breaking of all compatibility with old
 //  states, increment the upper 16 bit value, and clear the lower 16 bits to 0.
 
-static const u32 g_SaveVersion = (0x9A0D << 16) | 0x0000;
+static const u32 g_SaveVersion = (0x9A0D << 16) | 0x0001;
 
 // this function is meant to be used in the place of GSfreeze, and provides a safe layer
 // between the GS saving function and the MTGS's needs. :)
@@ -127,6 +127,7 @@ public:
 	virtual SaveStateBase& FreezeAll();
 
 	virtual SaveStateBase& FreezeMainMemory();
+	SaveStateBase& FreezeMainMemoryDelta( const VmStateBuffer& base, bool useDirtyTracking );
 	virtual SaveStateBase& FreezeBios();
 	virtual SaveStateBase& FreezeInternals();
 	virtual SaveStateBase& FreezePlugins();
@@ -258,3 +259,40 @@ public:
 	bool IsFinished() const { return m_idx >= m_memory->GetSizeInBytes(); }
 };
 
+// --------------------------------------------------------------------------------------
+//  memDeltaSavingState / memDeltaLoadingState
+// --------------------------------------------------------------------------------------
+// Incremental memory states: the main memory section only holds the pages which differ
+// from a base state (a full memSavingState buffer), the rest of the state is saved as
+// usual.  Loading a delta requires the very same base.  Use FreezeBase to create the base,
+// it also starts tracking the EE RAM pages written from then on, which saves a compare
+// of the whole 32MB on every delta.  The rewind buffer is built on them (see Rewind.h).
+class memDeltaSavingState : public memSavingState
+{
+protected:
+	const VmStateBuffer& m_base;
+
+public:
+	virtual ~memDeltaSavingState() = default;
+	memDeltaSavingState( VmStateBuffer& save_to, const VmStateBuffer& base );
+
+	static void FreezeBase( VmStateBuffer& base );
+	static void ReleaseBase();
+
+	SaveStateBase& FreezeMainMemory();
+};
+
+class memDeltaLoadingState : public memLoadingState
+{
+protected:
+	const VmStateBuffer& m_base;
+
+public:
+	virtual ~memDeltaLoadingState() = default;
+	memDeltaLoadingState( const VmStateBuffer& load_from, const VmStateBuffer& base );
+
+	static bool MatchesMainMemory( const VmStateBuffer& delta, const VmStateBuffer& base );
+
+	SaveStateBase& FreezeMainMemory();
+};
+
@@ -315,6 +315,8 @@ __fi void dmaSIF1()
 		SIF_LOG("warning, sif1.fifoReadPos != sif1.fifoWritePos");
 	}
 
+	iopSyncWithEE( IopSync_SifDma );
+
 	psHu32(SBUS_F240) |= 0x4000;
 	sif1.ee.busy = true;
 
@@ -24,6 +24,7 @@
 #include "Patch.h"
 #include "SysThreads.h"
 #include "MTVU.h"
+#include "Rewind.h"
 
 #include "../DebugTools/MIPSAnalyst.h"
 #include "../DebugTools/SymbolMap.h"
@@ -51,6 +52,7 @@ SysCoreThread::SysCoreThread()
 	m_resetVirtualMachine	= true;
 
 	m_hasActiveMachine		= false;
+	m_captureRewind			= false;
 }
 
 SysCoreThread::~SysCoreThread()
@@ -149,6 +151,8 @@ void SysCoreThread::ApplySettings( const Pcsx2Config& src )
 	m_resetProfilers		= ( src.Profiler != EmuConfig.Profiler );
 	m_resetVsyncTimers		= ( src.GS != EmuConfig.GS );
 
+	if( !src.Rewind.Enabled ) GetRewindBuffer().Clear();
+
 	const_cast<Pcsx2Config&>(EmuConfig) = src;
 }
 
@@ -167,7 +171,7 @@ void SysCoreThread::UploadStateCopy( const VmStateBuffer& copy )
 // --------------------------------------------------------------------------------------
 bool SysCoreThread::HasPendingStateChangeRequest() const
 {
-	return !m_hasActiveMachine || GetMTGS().HasPendingException() || _parent::HasPendingStateChangeRequest();
+	return !m_hasActiveMachine || m_captureRewind || GetMTGS().HasPendingException() || _parent::HasPendingStateChangeRequest();
 }
 
 void SysCoreThread::_reset_stuff_as_needed()
@@ -191,6 +195,7 @@ void SysCoreThread::_reset_stuff_as_needed()
 	if( m_resetVirtualMachine )
 	{
 		DoCpuReset();
+		GetRewindBuffer().Clear();
 
 		m_resetVirtualMachine	= false;
 		m_resetVsyncTimers		= false;
@@ -225,6 +230,10 @@ void SysCoreThread::DoCpuReset()
 void SysCoreThread::VsyncInThread()
 {
 	ApplyLoadedPatches(PPT_CONTINUOUSLY);
+
+	// The snapshot itself is taken once the cpu has left the recompiled code, see
+	// StateCheckInThread.
+	if( GetRewindBuffer().Vsync() ) m_captureRewind = true;
 }
 
 void SysCoreThread::GameStartingInThread()
@@ -241,7 +250,14 @@ void SysCoreThread::GameStartingInThread()
 bool SysCoreThread::StateCheckInThread()
 {
 	GetMTGS().RethrowException();
-	return _parent::StateCheckInThread() && (_reset_stuff_as_needed(), true);
+	const bool result = _parent::StateCheckInThread() && (_reset_stuff_as_needed(), true);
+
+	// Same point as regular savestates: the cpu is out of the recompiled code and the
+	// plugins are open.
+	if( m_captureRewind.exchange(false) && m_hasActiveMachine )
+		GetRewindBuffer().Capture();
+
+	return result;
 }
 
 // Runs CPU cycles indefinitely, until the user or another thread requests execution to break.
@@ -174,6 +174,9 @@ protected:
 	// occurs while trying to upload a new state into the VM.
 	std::atomic<bool> m_hasActiveMachine;
 
+	// Set at vsync when a rewind snapshot is due, makes the cpu leave the recompiled code.
+	std::atomic<bool> m_captureRewind;
+
 	wxString		m_elf_override;
 
 	SSE_MXCSR		m_mxcsr_saved;
@@ -139,6 +139,22 @@ public:
 	}
 };
 
+// --------------------------------------------------------------------------------------
+//  Chunked archive entries
+// --------------------------------------------------------------------------------------
+// Entries of ChunkedEntry_MinSize bytes or more (EE/IOP memory, most plugin blobs) are cut
+// in fixed size chunks which are deflated independently, on all cores.  The result (a small
+// chunk table followed by the deflated chunks) is stored uncompressed in the archive, so the
+// chunks can be inflated in parallel when loading as well.  Smaller entries aren't worth
+// the trouble and are deflated by the zip stream as usual.
+
+static const uint ChunkedEntry_MinSize		= _256kb;
+static const uint ChunkedEntry_ChunkSize	= _1mb;
+
+extern void CompressChunkedEntry( const u8* src, uint size, std::vector<u8>& dest );
+extern bool IsChunkedEntry( const u8* src, size_t size );
+extern void DecompressChunkedEntry( const wxString& streamname, const u8* src, size_t size, std::vector<u8>& dest );
+
 // --------------------------------------------------------------------------------------
 //  BaseCompressThread
 // --------------------------------------------------------------------------------------
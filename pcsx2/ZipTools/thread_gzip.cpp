@@ -21,6 +21,153 @@
 #include "Utilities/SafeArray.inl"
 #include "wx/wfstream.h"
 
+#include <atomic>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+#ifdef __POSIX__
+#include <zlib.h>
+#else
+#include <zlib/zlib.h>
+#endif
+
+// Layout of a chunked entry: this header, a u32 table with the deflated size of every
+// chunk, and then the chunks (zlib streams) back to back.
+struct ChunkedEntryHeader
+{
+	u32		magic;
+	u32		chunksize;
+	u32		rawsize;
+	u32		chunks;
+};
+
+static const u32 ChunkedEntry_Magic = 0x4b435a50;		// "PZCK"
+
+// Calls job(i) for every i in [0,count), spread over one thread per core (the calling
+// thread included).  Cancellation is disabled meanwhile: the helper threads reference
+// our stack and must be joined no matter what.
+static void ParallelFor( uint count, const std::function<void(uint)>& job )
+{
+	std::atomic<uint> next( 0 );
+	auto worker = [&]() {
+		for (uint i = next++; i < count; i = next++)
+			job( i );
+	};
+
+	const uint workers = std::max( 1u, std::min( count, std::thread::hardware_concurrency() ) );
+
+	int oldstate;
+	pthread_setcancelstate( PTHREAD_CANCEL_DISABLE, &oldstate );
+
+	std::vector<std::thread> threads;
+	for (uint i = 1; i < workers; ++i)
+	{
+		try {
+			threads.emplace_back( worker );
+		}
+		catch( std::system_error& )
+		{
+			break;	// fewer helpers, the remaining chunks are processed anyway
+		}
+	}
+
+	worker();
+
+	for (std::thread& thread : threads)
+		thread.join();
+
+	pthread_setcancelstate( oldstate, NULL );
+}
+
+void CompressChunkedEntry( const u8* src, uint size, std::vector<u8>& dest )
+{
+	const uint chunks	= (size + ChunkedEntry_ChunkSize - 1) / ChunkedEntry_ChunkSize;
+	const uint bound	= compressBound( ChunkedEntry_ChunkSize );
+
+	std::unique_ptr<u8[]> scratch( new u8[(size_t)chunks * bound] );
+	std::vector<uLongf> lengths( chunks );
+	std::vector<int> results( chunks );
+
+	ParallelFor( chunks, [&]( uint i ) {
+		const uint offset = i * ChunkedEntry_ChunkSize;
+		lengths[i] = bound;
+		results[i] = compress2( &scratch[(size_t)i * bound], &lengths[i], src + offset,
+			std::min( ChunkedEntry_ChunkSize, size - offset ), Z_DEFAULT_COMPRESSION );
+	});
+
+	size_t total = sizeof(ChunkedEntryHeader) + chunks * sizeof(u32);
+	for (uint i = 0; i < chunks; ++i)
+	{
+		if (results[i] != Z_OK)
+			throw Exception::RuntimeError().SetDiagMsg( pxsFmt( L"Failed to compress savestate data (zlib error %d).", results[i] ) );
+		total += lengths[i];
+	}
+
+	dest.resize( total );
+
+	ChunkedEntryHeader& header = *(ChunkedEntryHeader*)dest.data();
+	header.magic		= ChunkedEntry_Magic;
+	header.chunksize	= ChunkedEntry_ChunkSize;
+	header.rawsize		= size;
+	header.chunks		= chunks;
+
+	u32* table = (u32*)(dest.data() + sizeof(ChunkedEntryHeader));
+	u8* out = (u8*)(table + chunks);
+	for (uint i = 0; i < chunks; ++i)
+	{
+		table[i] = lengths[i];
+		memcpy( out, &scratch[(size_t)i * bound], lengths[i] );
+		out += lengths[i];
+	}
+}
+
+bool IsChunkedEntry( const u8* src, size_t size )
+{
+	return size >= sizeof(ChunkedEntryHeader) && ((const ChunkedEntryHeader*)src)->magic == ChunkedEntry_Magic;
+}
+
+void DecompressChunkedEntry( const wxString& streamname, const u8* src, size_t size, std::vector<u8>& dest )
+{
+	const ChunkedEntryHeader& header = *(const ChunkedEntryHeader*)src;
+	const u32* table = (const u32*)(src + sizeof(ChunkedEntryHeader));
+
+	bool valid = header.chunksize != 0
+		&& header.chunks == (header.rawsize + (u64)header.chunksize - 1) / header.chunksize
+		&& sizeof(ChunkedEntryHeader) + (u64)header.chunks * sizeof(u32) <= size;
+
+	// Chunk offsets, and a last one for the end of the data.
+	std::vector<size_t> offsets;
+	if (valid)
+	{
+		offsets.resize( header.chunks + 1 );
+		offsets[0] = sizeof(ChunkedEntryHeader) + header.chunks * sizeof(u32);
+		for (uint i = 0; i < header.chunks; ++i)
+			offsets[i + 1] = offsets[i] + table[i];
+		valid = offsets[header.chunks] <= size;
+	}
+
+	if (!valid)
+		throw Exception::BadStream( streamname ).SetDiagMsg( L"Chunked archive entry has an invalid chunk table." );
+
+	dest.resize( header.rawsize );
+
+	std::vector<int> results( header.chunks );
+	ParallelFor( header.chunks, [&]( uint i ) {
+		const size_t offset = (size_t)i * header.chunksize;
+		const uLongf expected = std::min<size_t>( header.chunksize, header.rawsize - offset );
+		uLongf length = expected;
+		results[i] = uncompress( &dest[offset], &length, src + offsets[i], offsets[i + 1] - offsets[i] );
+		if (results[i] == Z_OK && length != expected) results[i] = Z_DATA_ERROR;
+	});
+
+	for (uint i = 0; i < header.chunks; ++i)
+	{
+		if (results[i] != Z_OK)
+			throw Exception::BadStream( streamname ).SetDiagMsg( pxsFmt( L"Failed to decompress chunk %u of an archive entry (zlib error %d).", i, results[i] ) );
+	}
+}
+
 
 BaseCompressThread::~BaseCompressThread()
 {
@@ -55,6 +202,8 @@ void BaseCompressThread::ExecuteTaskInThread()
 	
 	Yield( 3 );
 
+	std::vector<u8> chunked;
+
 	uint listlen = m_src_list->GetLength();
 	for( uint i=0; i<listlen; ++i )
 	{
@@ -62,17 +211,33 @@ void BaseCompressThread::ExecuteTaskInThread()
 		if (!entry.GetDataSize()) continue;
 
 		wxArchiveOutputStream& woot = *(wxArchiveOutputStream*)m_gzfp->GetWxStreamBase();
-		woot.PutNextEntry( entry.GetFilename() );
+
+		const u8* data = m_src_list->GetPtr( entry.GetDataIndex() );
+		uint datasize = entry.GetDataSize();
+
+		if (datasize >= ChunkedEntry_MinSize)
+		{
+			// Already deflated, the zip stream only has to store it.
+			CompressChunkedEntry( data, datasize, chunked );
+			data = chunked.data();
+			datasize = chunked.size();
+
+			wxZipEntry* zentry = new wxZipEntry( entry.GetFilename() );
+			zentry->SetMethod( wxZIP_METHOD_STORE );
+			woot.PutNextEntry( zentry );
+		}
+		else
+			woot.PutNextEntry( entry.GetFilename() );
 
 		static const uint BlockSize = 0x64000;
 		uint curidx = 0;
 
 		do {
-			uint thisBlockSize = std::min( BlockSize, entry.GetDataSize() - curidx );
-			m_gzfp->Write(m_src_list->GetPtr( entry.GetDataIndex() + curidx ), thisBlockSize);
+			uint thisBlockSize = std::min( BlockSize, datasize - curidx );
+			m_gzfp->Write(data + curidx, thisBlockSize);
 			curidx += thisBlockSize;
 			Yield( 2 );
-		} while( curidx < entry.GetDataSize() );
+		} while( curidx < datasize );
 		
 		woot.CloseEntry();
 	}
@@ -60,6 +60,7 @@ extern void StateCopy_SaveToFile( const wxString& file );
 extern void StateCopy_LoadFromFile( const wxString& file );
 extern void StateCopy_SaveToSlot( uint num );
 extern void StateCopy_LoadFromSlot( uint slot, bool isFromBackup = false );
+extern void StateCopy_Rewind();
 
 extern void States_registerLoadBackupMenuItem( wxMenuItem* loadBackupMenuItem );
 
@@ -67,6 +68,7 @@ extern bool States_isSlotUsed(int num);
 extern void States_DefrostCurrentSlotBackup();
 extern void States_DefrostCurrentSlot();
 extern void States_FreezeCurrentSlot();
+extern void States_Rewind();
 extern void States_CycleSlotForward();
 extern void States_CycleSlotBackward();
 
@@ -49,6 +49,7 @@ void GSPanel::InitDefaultAccelerators()
 	m_Accels->Map( AAC( WXK_F3 ).Shift(),		"States_DefrostCurrentSlotBackup");
 	m_Accels->Map( AAC( WXK_F2 ),				"States_CycleSlotForward" );
 	m_Accels->Map( AAC( WXK_F2 ).Shift(),		"States_CycleSlotBackward" );
+	m_Accels->Map( AAC( WXK_F1 ).Shift(),		"States_Rewind" );
 
 	m_Accels->Map( AAC( WXK_F4 ),				"Framelimiter_MasterToggle");
 	m_Accels->Map( AAC( WXK_F4 ).Shift(),		"Frameskip_Toggle");
@@ -76,6 +77,7 @@ void GSPanel::InitDefaultAccelerators()
 	m_Accels->Map( AAC( WXK_F9 ),				"Sys_RenderswitchToggle");
 
 	m_Accels->Map( AAC( WXK_F10 ),				"Sys_LoggingToggle" );
+	m_Accels->Map( AAC( WXK_F10 ).Shift(),		"Sys_EEProfilerToggle" );
 	m_Accels->Map( AAC( WXK_F11 ),				"Sys_FreezeGS" );
 	m_Accels->Map( AAC( WXK_F12 ),				"Sys_RecordingToggle" );
 
@@ -589,6 +591,12 @@ void GSFrame::OnUpdateTitle( wxTimerEvent& evt )
 				cpuUsage.Write(L" | VU: %3d%%", m_CpuUsage.GetVUPct());
 
 			pxNonReleaseCode(cpuUsage.Write(L" | UI: %3d%%", m_CpuUsage.GetGuiPct()));
+
+#if defined(PCSX2_DEBUG) || defined(PCSX2_DEVBUILD)
+			// MTGS ring stalls of the last frame, see SysMtgsThread::GetStallStats.
+			const MTGS_StallStats stalls(GetMTGS().GetStallStats());
+			cpuUsage.Write(L" | EE stall: %.1fms (%u) | GS idle: %.1fms", stalls.EEStallMs, stalls.EEStalls, stalls.GSIdleMs);
+#endif
 		}
 
 		if (THREAD_VU1)
@@ -29,6 +29,7 @@
 #include "Dump.h"
 #include "DebugTools/Debug.h"
 #include "R3000A.h"
+#include "x86/R5900_Profiler.h"
 
 // renderswitch - tells GSdx to go into dx9 sw if "renderswitch" is set.
 bool renderswitch = false;
@@ -376,6 +377,27 @@ namespace Implementations
 #endif
 	}
 
+	void Sys_EEProfilerToggle()
+	{
+		if (!CHECK_EEREC) {
+			Console.Warning("The EE block profiler needs the EE recompiler.");
+			return;
+		}
+
+		ScopedCoreThreadPause paused_core;
+
+		const bool enable = !EE::BlockProfiler.IsEnabled();
+		if (!enable)
+			EE::BlockProfiler.Print();
+		EE::BlockProfiler.SetEnabled(enable);
+
+		// Blocks get (or lose) their counters when they are recompiled
+		Cpu->Reset();
+
+		Console.WriteLn(enable ? "EE block profiler enabled." : "EE block profiler disabled.");
+		paused_core.AllowResume();
+	}
+
 	void Sys_FreezeGS()
 	{
 		// fixme : fix up gsstate mess and make it mtgs compatible -- air
@@ -493,6 +515,13 @@ static const GlobalCommandDescriptor CommandDeclarations[] =
 		false,
 	},
 
+	{	"States_Rewind",
+		States_Rewind,
+		pxL( "Rewind" ),
+		pxL( "Goes back to the most recent rewind snapshot." ),
+		false,
+	},
+
 	{	"States_CycleSlotForward",
 		States_CycleSlotForward,
 		pxL( "Cycle to next slot" ),
@@ -601,6 +630,13 @@ static const GlobalCommandDescriptor CommandDeclarations[] =
 		false,
 	},
 
+	{	"Sys_EEProfilerToggle",
+		Implementations::Sys_EEProfilerToggle,
+		NULL,
+		NULL,
+		false,
+	},
+
 	{	"Sys_FreezeGS",
 		Implementations::Sys_FreezeGS,
 		NULL,
@@ -119,6 +119,25 @@ void States_DefrostCurrentSlotBackup()
 	_States_DefrostCurrentSlot( true );
 }
 
+void States_Rewind()
+{
+	if( !SysHasValidState() )
+	{
+		Console.WriteLn( "Rewind: Aborting (VM is not active)." );
+		return;
+	}
+
+	if( IsSavingOrLoading.exchange(true) )
+	{
+		Console.WriteLn( "Load or save action is already pending." );
+		return;
+	}
+
+	StateCopy_Rewind();
+
+	GetSysExecutorThread().PostIdleEvent( SysExecEvent_ClearSavingLoadingFlag() );
+}
+
 
 void States_registerLoadBackupMenuItem( wxMenuItem* loadBackupMenuItem )
 {
@@ -19,6 +19,7 @@
 
 #include "System/SysThreads.h"
 #include "SaveState.h"
+#include "Rewind.h"
 #include "VUmicro.h"
 
 #include "ZipTools/ThreadedZipTools.h"
@@ -27,6 +28,7 @@
 #include "ConsoleLogger.h"
 
 #include <wx/wfstream.h>
+#include <wx/mstream.h>
 #include <memory>
 
 #include "Patch.h"
@@ -298,6 +300,30 @@ static void CheckVersion( pxInputStream& thr )
 			.SetUserMsg(_("Cannot load this savestate. The state is an unsupported version."));
 };
 
+// Opens the entry for reading.  Stored entries are loaded in memory, and inflated on all
+// cores if they were saved as chunks (see CompressChunkedEntry); returns true in that case
+// and the data is in dest.  Otherwise the entry has to be read from the stream.
+static bool OpenSavestateEntry( pxInputStream& reader, wxZipEntry& entry, std::vector<u8>& dest )
+{
+	wxZipInputStream* gzreader = (wxZipInputStream*)reader.GetWxStreamBase();
+	gzreader->OpenEntry( entry );
+
+	dest.clear();
+	if (entry.GetMethod() != wxZIP_METHOD_STORE || entry.GetSize() <= 0) return false;
+
+	dest.resize( entry.GetSize() );
+	reader.Read( dest.data(), dest.size() );
+
+	if (IsChunkedEntry( dest.data(), dest.size() ))
+	{
+		std::vector<u8> stored;
+		stored.swap( dest );
+		DecompressChunkedEntry( reader.GetStreamName(), stored.data(), stored.size(), dest );
+	}
+
+	return true;
+}
+
 // --------------------------------------------------------------------------------------
 //  SysExecEvent_DownloadState
 // --------------------------------------------------------------------------------------
@@ -609,28 +635,70 @@ protected:
 		GetCoreThread().Pause();
 		SysClearExecutionCache();
 
+		std::vector<u8> data;
+
 		for (uint i=0; i<ArraySize(SavestateEntries); ++i)
 		{
 			if (!foundEntry[i]) continue;
 
 			Threading::pxTestCancel();
 
-			gzreader->OpenEntry( *foundEntry[i] );
-			SavestateEntries[i]->FreezeIn( *reader );
+			if (OpenSavestateEntry( *reader, *foundEntry[i], data ))
+			{
+				pxInputStream memreader( m_filename, new wxMemoryInputStream( data.data(), data.size() ) );
+				SavestateEntries[i]->FreezeIn( memreader );
+			}
+			else
+				SavestateEntries[i]->FreezeIn( *reader );
 		}
 
 		// Load all the internal data
 
-		gzreader->OpenEntry( *foundInternal );
+		const bool inMemory = OpenSavestateEntry( *reader, *foundInternal, data );
+		const uint internalSize = inMemory ? data.size() : foundInternal->GetSize();
 
-		VmStateBuffer buffer( foundInternal->GetSize(), L"StateBuffer_UnzipFromDisk" );		// start with an 8 meg buffer to avoid frequent reallocation.
-		reader->Read( buffer.GetPtr(), foundInternal->GetSize() );
+		VmStateBuffer buffer( internalSize, L"StateBuffer_UnzipFromDisk" );
+		if (inMemory)
+			memcpy( buffer.GetPtr(), data.data(), internalSize );
+		else
+			reader->Read( buffer.GetPtr(), internalSize );
 
 		memLoadingState( buffer ).FreezeBios().FreezeInternals();
 		GetCoreThread().Resume();	// force resume regardless of emulation state earlier.
 	}
 };
 
+// --------------------------------------------------------------------------------------
+//  SysExecEvent_Rewind
+// --------------------------------------------------------------------------------------
+class SysExecEvent_Rewind : public SysExecEvent
+{
+public:
+	wxString GetEventName() const { return L"VM_Rewind"; }
+
+	virtual ~SysExecEvent_Rewind() = default;
+	SysExecEvent_Rewind* Clone() const { return new SysExecEvent_Rewind( *this ); }
+
+protected:
+	void InvokeEvent()
+	{
+		GetCoreThread().Pause();
+
+		SysClearExecutionCache();
+		if( !GetRewindBuffer().Load() )
+		{
+			OSDlog( Color_StrongGreen, true, "Rewind: no snapshot available." );
+			GetCoreThread().Resume();
+			return;
+		}
+
+		GetCoreThread().Resume();	// force resume regardless of emulation state earlier.
+
+		const RewindBuffer::Stats stats( GetRewindBuffer().GetStats() );
+		OSDlog( Color_StrongGreen, true, "Rewind: %u snapshot(s) left.", stats.snapshots );
+	}
+};
+
 // =====================================================================================================
 //  StateCopy Public Interface
 // =====================================================================================================
@@ -676,6 +744,12 @@ void StateCopy_SaveToSlot( uint num )
 	StateCopy_SaveToFile( file );
 }
 
+void StateCopy_Rewind()
+{
+	UI_DisableSysActions();
+	GetSysExecutorThread().PostEvent(new SysExecEvent_Rewind());
+}
+
 void StateCopy_LoadFromSlot( uint slot, bool isFromBackup )
 {
 	wxString file( SaveStateBase::GetFilename( slot ) + wxString( isFromBackup?L".backup":L"" ) );
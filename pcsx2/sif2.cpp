@@ -377,6 +377,8 @@ __fi void dmaSIF2()
 		SIF_LOG("warning, sif2.fifoReadPos != sif2.fifoWritePos");
 	}
 
+	iopSyncWithEE( IopSync_SifDma );
+
 	//if(sif2dma.chcr.MOD == CHAIN_MODE && sif2dma.qwc > 0) DevCon.Warning(L"SIF2 QWC on Chain CHCR " + sif2dma.chcr.desc());
 	psHu32(SBUS_F240) |= 0x8000;
 	sif2.ee.busy = true;
@@ -661,6 +661,54 @@ __fi u32 vtlb_V2P(u32 vaddr)
 	return paddr;
 }
 
+static const u32 VTLB_RAM_PAGES = Ps2MemSize::MainRam >> VTLB_PAGE_BITS;
+
+static __fi bool vtlb_IsDirectPage(u32 page)
+{
+	return vtlbdata.vmap[page] == (sptr)eeMem->Main;
+}
+
+// Keeps vtlbdata.directStart/directSize on a run of virtual pages which map 1:1 to the EE RAM.
+// It isn't always the longest run, but all the pages in it always are, since the recompiled
+// code relies on it (vtlb_DynGenRead32 and co).
+static void vtlb_UpdateDirectWindow(u32 page)
+{
+	u32 start = vtlbdata.directStart >> VTLB_PAGE_BITS;
+	u32 end   = start + (vtlbdata.directSize >> VTLB_PAGE_BITS);
+
+	if (!vtlb_IsDirectPage(page))
+	{
+		if (page < start || page >= end) return;
+
+		// keep the larger side of the window
+		if (page - start >= end - page - 1)
+			end = page;
+		else
+			start = page + 1;
+	}
+	else
+	{
+		if (start == end)
+			start = end = page;
+		else if (page != end && page + 1 != start)
+			return;
+
+		while (start > 0 && vtlb_IsDirectPage(start - 1)) start--;
+		while (end < VTLB_RAM_PAGES && vtlb_IsDirectPage(end)) end++;
+	}
+
+	vtlbdata.directStart = start << VTLB_PAGE_BITS;
+	vtlbdata.directSize  = (end - start) << VTLB_PAGE_BITS;
+}
+
+static __fi void vtlb_SetVMap(u32 vaddr, sptr value)
+{
+	vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = value;
+
+	if ((vaddr>>VTLB_PAGE_BITS) < VTLB_RAM_PAGES)
+		vtlb_UpdateDirectWindow(vaddr>>VTLB_PAGE_BITS);
+}
+
 //virtual mappings
 //TODO: Add invalid paddr checks
 void vtlb_VMap(u32 vaddr,u32 paddr,u32 size)
@@ -687,7 +735,7 @@ void vtlb_VMap(u32 vaddr,u32 paddr,u32 size)
 				pme |= paddr;// top bit is set anyway ...
 		}
 
-		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = pme-vaddr;
+		vtlb_SetVMap(vaddr, pme-vaddr);
 		if (vtlbdata.ppmap)
 			if (!(vaddr & 0x80000000)) // those address are already physical don't change them
 				vtlbdata.ppmap[vaddr>>VTLB_PAGE_BITS] = paddr & ~VTLB_PAGE_MASK;
@@ -706,7 +754,7 @@ void vtlb_VMapBuffer(u32 vaddr,void* buffer,u32 size)
 	uptr bu8 = (uptr)buffer;
 	while (size > 0)
 	{
-		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = bu8-vaddr;
+		vtlb_SetVMap(vaddr, bu8-vaddr);
 		vaddr += VTLB_PAGE_SIZE;
 		bu8 += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
@@ -729,7 +777,7 @@ void vtlb_VMapUnmap(u32 vaddr,u32 size)
 		handl |= vaddr; // top bit is set anyway ...
 		handl |= 0x80000000;
 
-		vtlbdata.vmap[vaddr>>VTLB_PAGE_BITS] = handl-vaddr;
+		vtlb_SetVMap(vaddr, handl-vaddr);
 		vaddr += VTLB_PAGE_SIZE;
 		size -= VTLB_PAGE_SIZE;
 	}
@@ -767,6 +815,8 @@ void vtlb_Init()
 	vtlb_MapHandler(DefaultPhyHandler,0,VTLB_PMAP_SZ);
 
 	//Set the V space as unmapped
+	vtlbdata.directStart = 0;
+	vtlbdata.directSize  = 0;
 	vtlb_VMapUnmap(0,(VTLB_VMAP_ITEMS-1)*VTLB_PAGE_SIZE);
 	//yeah i know, its stupid .. but this code has to be here for now ;p
 	vtlb_VMapUnmap((VTLB_VMAP_ITEMS-1)*VTLB_PAGE_SIZE,VTLB_PAGE_SIZE);
@@ -204,10 +204,17 @@ namespace vtlb_private
 
 		u32* ppmap;               //4MB (allocated by vtlb_init) // PS2 virtual to PS2 physical
 
+		// Virtual addresses [directStart, directStart+directSize) are mapped 1:1 to the EE RAM,
+		// so the recompiled code accesses them at eeMem->Main+addr without a vmap lookup.
+		u32 directStart;
+		u32 directSize;
+
 		MapData()
 		{
 			vmap = NULL;
 			ppmap = NULL;
+			directStart = 0;
+			directSize = 0;
 		}
 	};
 
@@ -20,9 +20,11 @@
 BASEBLOCKEX* BaseBlocks::New(u32 startpc, uptr fnptr)
 {
 	std::pair<linkiter_t, linkiter_t> range = links.equal_range(startpc);
-	for (linkiter_t i = range.first; i != range.second; ++i)
+	for (linkiter_t i = range.first; i != range.second; ++i) {
 		*(u32*)i->second = fnptr - (i->second + 4);
-	
+		stats.patched++;
+	}
+
 	return blocks.insert(startpc, fnptr);;
 }
 
@@ -73,10 +75,42 @@ BASEBLOCKEX* BaseBlocks::GetByX86(uptr ip)
 void BaseBlocks::Link(u32 pc, s32* jumpptr)
 {
 	BASEBLOCKEX *targetblock = Get(pc);
-	if (targetblock && targetblock->startpc == pc)
+	if (targetblock && targetblock->startpc == pc) {
 		*jumpptr = (s32)(targetblock->fnptr - (sptr)(jumpptr + 1));
-	else
+		stats.direct++;
+	} else {
 		*jumpptr = (s32)(recompiler - (sptr)(jumpptr + 1));
+		stats.pending++;
+	}
 	links.insert(std::pair<u32, uptr>(pc, (uptr)jumpptr));
+	sources[(uptr)jumpptr] = pc;
+}
+
+// Drops the links made by the jumps in the code of a block
+void BaseBlocks::Unlink(const BASEBLOCKEX& block)
+{
+	sourceiter_t first = sources.lower_bound(block.fnptr);
+	sourceiter_t last  = sources.lower_bound(block.fnptr + block.x86size);
+
+	for (sourceiter_t i = first; i != last; ++i) {
+		std::pair<linkiter_t, linkiter_t> range = links.equal_range(i->second);
+		for (linkiter_t link = range.first; link != range.second; ++link) {
+			if (link->second == i->first) {
+				links.erase(link);
+				break;
+			}
+		}
+	}
+
+	sources.erase(first, last);
+}
+
+void BaseBlocks::PrintStats(const char* name) const
+{
+	if (!stats.direct && !stats.pending)
+		return;
+
+	DevCon.WriteLn("%s block links: %u direct, %u to JITCompile (%u back-patched), %u unlinked, %u live, %u dispatched exits",
+		name, stats.direct, stats.pending, stats.patched, stats.unlinked, (u32)links.size(), stats.dispatched);
 }
 
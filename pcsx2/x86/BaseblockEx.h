@@ -44,6 +44,16 @@ struct BASEBLOCKEX
 
 };
 
+// Counters of the static links between blocks (see BaseBlocks::Link)
+struct BaseBlockLinkStats
+{
+	u32 direct;		// jumps linked to a block which was already compiled
+	u32 pending;	// jumps linked to JITCompile because their target wasn't compiled yet
+	u32 patched;	// jumps back-patched when their target got compiled
+	u32 unlinked;	// jumps sent back to JITCompile when their target got cleared
+	u32 dispatched;	// exits through the register dispatcher (dev builds only, counted by the dispatcher)
+};
+
 class BaseBlockArray {
 	s32 _Reserved;
 	s32 _Size;
@@ -144,17 +154,23 @@ class BaseBlocks
 {
 protected:
 	typedef std::multimap<u32, uptr>::iterator linkiter_t;
+	typedef std::map<uptr, u32>::iterator sourceiter_t;
 
 	// switch to a hash map later?
-	std::multimap<u32, uptr> links;
+	std::multimap<u32, uptr> links;		// target pc -> jump
+	std::map<uptr, u32> sources;		// jump -> target pc, to find the links made by a block
 	uptr recompiler;
 	BaseBlockArray blocks;
+	BaseBlockLinkStats stats;
+
+	void Unlink(const BASEBLOCKEX& block);
 
 public:
 	BaseBlocks() :
 		recompiler(0)
 	,	blocks(0x4000)
 	{
+		memzero(stats);
 	}
 
 	void SetJITCompile( void (*recompiler_)() )
@@ -199,8 +215,10 @@ public:
 
 			//u32 startpc = blocks[idx].startpc;
 			std::pair<linkiter_t, linkiter_t> range = links.equal_range(blocks[idx].startpc);
-			for (linkiter_t i = range.first; i != range.second; ++i)
+			for (linkiter_t i = range.first; i != range.second; ++i) {
 				*(u32*)i->second = recompiler - (i->second + 4);
+				stats.unlinked++;
+			}
 
 			if( IsDevBuild )
 			{
@@ -215,16 +233,26 @@ public:
 		}
 		while(idx++ < last);
 
-		// TODO: remove links from this block?
+		// The code of the removed blocks is dead, forget the jumps it contains.  This is done
+		// after the loop above so that the jumps between two removed blocks were sent back to
+		// JITCompile first (a block can still be running when it's removed).
+		for (idx = first; idx <= last; idx++)
+			Unlink(blocks[idx]);
+
 		blocks.erase(first, last + 1);
 	}
 
 	void Link(u32 pc, s32* jumpptr);
 
+	BaseBlockLinkStats& Stats() { return stats; }
+	void PrintStats(const char* name) const;
+
 	__fi void Reset()
 	{
 		blocks.clear();
 		links.clear();
+		sources.clear();
+		memzero(stats);
 	}
 };
 
@@ -0,0 +1,164 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2017  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PrecompiledHeader.h"
+#include "iR5900.h"
+#include "DebugTools/SymbolMap.h"
+
+#include "AppConfig.h"
+#include "Utilities/AsciiFile.h"
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+using namespace x86Emitter;
+
+eeBlockProfiler EE::BlockProfiler;
+
+eeBlockProfiler::eeBlockProfiler()
+	: m_count(0)
+	, m_enabled(false)
+{
+}
+
+void eeBlockProfiler::SetEnabled(bool enabled)
+{
+	if (enabled && !m_enabled) {
+		m_count = 0;
+		m_retired.clear();
+	}
+
+	m_enabled = enabled;
+}
+
+// Emits the hit counter of a block at the current emitter position
+eeBlockProfile* eeBlockProfiler::EmitBlockEntry(u32 startpc, uptr fnptr)
+{
+	if (m_count == m_chunks.size() * ChunkSize)
+		m_chunks.emplace_back(new eeBlockProfile[ChunkSize]);
+
+	eeBlockProfile& block = m_chunks[m_count / ChunkSize][m_count % ChunkSize];
+	m_count++;
+
+	memzero(block);
+	block.startpc = startpc;
+	block.fnptr   = fnptr;
+
+	xADD(ptr32[&((u32*)&block.hits)[0]], 1);
+	xADC(ptr32[&((u32*)&block.hits)[1]], 0);
+
+	return &block;
+}
+
+void eeBlockProfiler::Accumulate(std::map<u32, Totals>& totals, const eeBlockProfile& block) const
+{
+	if (!block.hits) return;
+
+	Totals& total  = totals[block.startpc];
+	total.hits    += block.hits;
+	total.cycles  += block.hits * block.cycles;
+	total.size     = block.size;
+	total.x86size  = block.x86size;
+}
+
+// Called when the recompiler throws away all of its blocks: keeps their counts and frees
+// their counters for the next blocks.
+void eeBlockProfiler::Retire()
+{
+	for (u32 i = 0; i < m_count; i++)
+		Accumulate(m_retired, m_chunks[i / ChunkSize][i % ChunkSize]);
+
+	m_count = 0;
+}
+
+static std::string eeBlockFunction(u32 pc)
+{
+	const u32 start = symbolMap.GetFunctionStart(pc);
+	const char* name = (start != SymbolMap::INVALID_ADDRESS) ? symbolMap.GetLabelName(start) : NULL;
+	return name ? name : "";
+}
+
+// Writes the blocks sorted by EE cycles to <logs>/EEprofile.txt, the same as folded stacks
+// for flamegraph.pl to <logs>/EEprofile.folded, and on Linux the symbols of the current
+// blocks to /tmp/perf-<pid>.map (the format of Perf::InfoVector) for perf report.
+void eeBlockProfiler::Print()
+{
+	std::map<u32, Totals> totals(m_retired);
+	for (u32 i = 0; i < m_count; i++)
+		Accumulate(totals, m_chunks[i / ChunkSize][i % ChunkSize]);
+
+	if (totals.empty()) {
+		Console.WriteLn(Color_StrongBlack, "EE block profiler: no block was executed");
+		return;
+	}
+
+	std::vector<std::pair<u32, Totals>> sorted(totals.begin(), totals.end());
+	std::sort(sorted.begin(), sorted.end(), [](const std::pair<u32, Totals>& a, const std::pair<u32, Totals>& b) {
+		return a.second.cycles > b.second.cycles;
+	});
+
+	u64 allHits = 0, allCycles = 0;
+	for (const auto& it : sorted) {
+		allHits   += it.second.hits;
+		allCycles += it.second.cycles;
+	}
+
+	g_Conf->Folders.Logs.Mkdir();
+	const wxString reportName(Path::Combine(g_Conf->Folders.Logs, L"EEprofile.txt"));
+	const wxString foldedName(Path::Combine(g_Conf->Folders.Logs, L"EEprofile.folded"));
+
+	AsciiFile report(reportName, L"w");
+	AsciiFile folded(foldedName, L"w");
+
+	report.Printf("%u blocks, %llu executions, %llu EE cycles\n\n", (u32)sorted.size(),
+		(unsigned long long)allHits, (unsigned long long)allCycles);
+	report.Printf("        PC  size  x86size          hits            cycles       %%  function\n");
+
+	Console.WriteLn(Color_StrongBlack, "EE block profiler: %u blocks, %llu EE cycles. Hottest blocks:",
+		(u32)sorted.size(), (unsigned long long)allCycles);
+
+	int printed = 0;
+	for (const auto& it : sorted) {
+		const Totals& block = it.second;
+		const std::string function(eeBlockFunction(it.first));
+		const double percent = (double)block.cycles / (double)allCycles * 100.0;
+
+		report.Printf("0x%08x %5u %8u %13llu %17llu %6.2f%%  %s\n", it.first, block.size, block.x86size,
+			(unsigned long long)block.hits, (unsigned long long)block.cycles, percent, function.c_str());
+
+		if (function.empty())
+			folded.Printf("EE;EE_0x%08x %llu\n", it.first, (unsigned long long)block.cycles);
+		else
+			folded.Printf("EE;%s;EE_0x%08x %llu\n", function.c_str(), it.first, (unsigned long long)block.cycles);
+
+		if (printed++ < 20)
+			Console.WriteLn("\t0x%08x %4u insts %6.2f%% %s", it.first, block.size, percent, function.c_str());
+	}
+
+#ifdef __linux__
+	char perfMap[64];
+	snprintf(perfMap, sizeof(perfMap), "/tmp/perf-%d.map", getpid());
+	if (FILE* fp = fopen(perfMap, "w")) {
+		for (u32 i = 0; i < m_count; i++) {
+			const eeBlockProfile& block = m_chunks[i / ChunkSize][i % ChunkSize];
+			fprintf(fp, "%lx %x EE_0x%08x\n", (unsigned long)block.fnptr, block.x86size, block.startpc);
+		}
+		fclose(fp);
+	}
+#endif
+
+	Console.WriteLn(Color_StrongBlack, L"EE block profiler: report saved to '%s'", WX_STR(reportName));
+}
@@ -1,5 +1,5 @@
 /*  PCSX2 - PS2 Emulator for PCs
- *  Copyright (C) 2002-2015  PCSX2 Dev Team
+ *  Copyright (C) 2002-2017  PCSX2 Dev Team
  *
  *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
  *  of the GNU Lesser General Public License as published by the Free Software Found-
@@ -15,6 +15,9 @@
 
 #pragma once
 #include "Pcsx2Defs.h"
+#include <map>
+#include <memory>
+#include <vector>
 
 // Keep my nice alignment please!
 #define MOVZ MOVZtemp
@@ -404,6 +407,56 @@ struct eeProfiler {
 };
 #endif
 
+// --------------------------------------------------------------------------------------
+//  eeBlockProfiler
+// --------------------------------------------------------------------------------------
+// Unlike eeProfiler, this one is switched at runtime (Sys_EEProfilerToggle, Shift+F10 by
+// default).  While it's enabled every block compiled by the EE recompiler counts its own
+// executions; the EE cycles of a block are what the recompiler charges for one run through
+// it, so they are estimates for blocks which are left early (exceptions, syscalls).
+// Turning it off writes the report (see Print).
+
+struct eeBlockProfile {
+	u64  hits;		// incremented by the recompiled code
+	u32  startpc;
+	u32  size;		// in instructions
+	u32  x86size;
+	u32  cycles;	// EE cycles of one execution
+	uptr fnptr;
+};
+
+class eeBlockProfiler {
+	// Counters are allocated by chunks which never move, the recompiled code points into them
+	static const u32 ChunkSize = 4096;
+
+	struct Totals {
+		u64 hits;
+		u64 cycles;
+		u32 size;
+		u32 x86size;
+	};
+
+	std::vector<std::unique_ptr<eeBlockProfile[]>> m_chunks;
+	u32  m_count;
+	bool m_enabled;
+
+	// Blocks thrown away by a recompiler reset, by start pc
+	std::map<u32, Totals> m_retired;
+
+	void Accumulate(std::map<u32, Totals>& totals, const eeBlockProfile& block) const;
+
+public:
+	eeBlockProfiler();
+
+	bool IsEnabled() const { return m_enabled; }
+	void SetEnabled(bool enabled);
+
+	eeBlockProfile* EmitBlockEntry(u32 startpc, uptr fnptr);
+	void Retire();
+	void Print();
+};
+
 namespace EE {
 	extern eeProfiler Profiler;
+	extern eeBlockProfiler BlockProfiler;
 }
@@ -149,6 +149,9 @@ static DynGenFunc* _DynGen_DispatcherReg()
 {
 	u8* retval = xGetPtr();
 
+	if (IsDevBuild)
+		xADD( ptr32[&recBlocks.Stats().dispatched], 1 );
+
 	xMOV( eax, ptr[&psxRegs.pc] );
 	xMOV( ebx, eax );
 	xSHR( eax, 16 );
@@ -725,6 +728,7 @@ void recResetIOP()
 	if( s_pInstCache )
 		memset( s_pInstCache, 0, sizeof(EEINST)*s_nInstCacheSize );
 
+	recBlocks.PrintStats("IOP");
 	recBlocks.Reset();
 	g_psxMaxRecMem = 0;
 
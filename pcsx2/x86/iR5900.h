@@ -70,6 +70,7 @@ void LoadBranchState();
 void recompileNextInstruction(int delayslot);
 void SetBranchReg( u32 reg );
 void SetBranchImm( u32 imm );
+bool recFollowJump( u32 newpc );
 
 void iFlushCall(int flushtype);
 void recBranchCall( void (*func)() );
@@ -43,6 +43,9 @@
 #include "Utilities/MemsetFast.inl"
 #include "Utilities/Perf.h"
 
+#include <unordered_map>
+#include <unordered_set>
+
 
 using namespace x86Emitter;
 using namespace R5900;
@@ -96,6 +99,25 @@ u32 s_nEndBlock = 0; // what pc the current block ends
 u32 s_branchTo;
 static bool s_nBlockFF;
 
+// Tier 2: a block ending with a J/JAL to a forward address of its page counts down its
+// executions, and once it has run recTier2Threshold times it's recompiled with the jump
+// followed.  The jump target is compiled into the same block, so the constants and the
+// registers allocated before the jump carry over instead of being flushed at a block link.
+static const u32 recTier2Threshold = 4096;
+static const int recTier2MaxJumps  = 4;		// jumps followed per block
+
+static u32 s_tier2Counters[0x4000];			// countdowns of the tier 1 blocks
+static u32 s_tier2CounterCount = 0;			// slots used so far, freed ones go to s_tier2FreeCounters
+static std::vector<u32> s_tier2FreeCounters;	// slots of the cleared blocks
+static std::unordered_map<u32, u32> s_tier2CounterSlots;	// physical address of a block -> its slot
+static std::unordered_set<u32> s_tier2Blocks;	// physical addresses of the promoted blocks
+
+static bool s_blockTier2;					// current block is a tier 2 block
+static bool s_blockCanFollow;				// current block ends with a jump tier 2 would follow
+static u32 s_blockStartPC;
+static u32 s_followedJumps[recTier2MaxJumps];	// addresses of the jumps followed by the current block
+static int s_followedJumpCount;
+
 // save states for branches
 GPR_reg64 s_saveConstRegs[32];
 static u32 s_saveHasConstReg = 0, s_saveFlushedConstReg = 0;
@@ -317,6 +339,7 @@ void recCall( void (*func)() )
 static void __fastcall recRecompile( const u32 startpc );
 static void __fastcall dyna_block_discard(u32 start,u32 sz);
 static void __fastcall dyna_page_reset(u32 start,u32 sz);
+static void __fastcall dyna_block_promote(u32 start);
 
 // Recompiled code buffer for EE recompiler dispatchers!
 static u8 __pagealigned eeRecDispatchers[__pagesize];
@@ -331,6 +354,7 @@ static DynGenFunc* EnterRecompiledCode	= NULL;
 static DynGenFunc* ExitRecompiledCode	= NULL;
 static DynGenFunc* DispatchBlockDiscard = NULL;
 static DynGenFunc* DispatchPageReset    = NULL;
+static DynGenFunc* DispatchBlockPromote = NULL;
 
 static void recEventTest()
 {
@@ -368,6 +392,9 @@ static DynGenFunc* _DynGen_DispatcherReg()
 {
 	u8* retval = xGetPtr();		// fallthrough target, can't align it!
 
+	if (IsDevBuild)
+		xADD( ptr32[&recBlocks.Stats().dispatched], 1 );
+
 	xMOV( eax, ptr[&cpuRegs.pc] );
 	xMOV( ebx, eax );
 	xSHR( eax, 16 );
@@ -426,6 +453,16 @@ static DynGenFunc* _DynGen_DispatchPageReset()
 	return (DynGenFunc*)retval;
 }
 
+// The block is entered with cpuRegs.pc already set, so once it's cleared JITCompile
+// recompiles it right away as a tier 2 block.
+static DynGenFunc* _DynGen_DispatchBlockPromote()
+{
+	u8* retval = xGetPtr();
+	xFastCall((void*)dyna_block_promote);
+	xJMP((void*)JITCompile);
+	return (DynGenFunc*)retval;
+}
+
 static void _DynGen_Dispatchers()
 {
 	// In case init gets called multiple times:
@@ -446,6 +483,7 @@ static void _DynGen_Dispatchers()
 	EnterRecompiledCode  = _DynGen_EnterRecompiledCode();
 	DispatchBlockDiscard = _DynGen_DispatchBlockDiscard();
 	DispatchPageReset    = _DynGen_DispatchPageReset();
+	DispatchBlockPromote = _DynGen_DispatchBlockPromote();
 
 	HostSys::MemProtectStatic( eeRecDispatchers, PageAccess_ExecOnly() );
 
@@ -580,6 +618,7 @@ static void recResetRaw()
 	Perf::ee.reset();
 
 	EE::Profiler.Reset();
+	EE::BlockProfiler.Retire();
 
 	recAlloc();
 
@@ -599,9 +638,15 @@ static void recResetRaw()
 	if( s_pInstCache )
 		memset( s_pInstCache, 0, sizeof(EEINST)*s_nInstCacheSize );
 
+	recBlocks.PrintStats("EE");
 	recBlocks.Reset();
 	mmap_ResetBlockTracking();
 
+	s_tier2CounterCount = 0;
+	s_tier2FreeCounters.clear();
+	s_tier2CounterSlots.clear();
+	s_tier2Blocks.clear();
+
 	x86SetPtr(*recMem);
 
 	recPtr = *recMem;
@@ -764,6 +809,39 @@ void R5900::Dynarec::OpcodeImpl::recBREAK()
 	//g_branch = 2;
 }
 
+// Countdown of the tier 1 block at startpc (physical), NULL when all the slots are in use
+static u32* recAllocTier2Counter(u32 startpc)
+{
+	u32 slot;
+
+	if (!s_tier2FreeCounters.empty()) {
+		slot = s_tier2FreeCounters.back();
+		s_tier2FreeCounters.pop_back();
+	}
+	else if (s_tier2CounterCount < ArraySize(s_tier2Counters))
+		slot = s_tier2CounterCount++;
+	else
+		return NULL;
+
+	s_tier2CounterSlots[startpc] = slot;
+	s_tier2Counters[slot] = recTier2Threshold;
+
+	return &s_tier2Counters[slot];
+}
+
+// Gives back the countdown of a cleared block.  Its code only decrements it on entry, which
+// can't happen again once the block is removed.
+static void recFreeTier2Counter(u32 startpc)
+{
+	auto it = s_tier2CounterSlots.find(startpc);
+
+	if (it == s_tier2CounterSlots.end())
+		return;
+
+	s_tier2FreeCounters.push_back(it->second);
+	s_tier2CounterSlots.erase(it);
+}
+
 // Size is in dwords (4 bytes)
 void recClear(u32 addr, u32 size)
 {
@@ -778,6 +856,15 @@ void recClear(u32 addr, u32 size)
 
 	u32 lowerextent = (u32)-1, upperextent = 0, ceiling = (u32)-1;
 
+	// A tier 2 block spans the blocks of the jumps it followed, which stay live, so a block
+	// ending before addr doesn't mean the blocks further back end before it too.  No block goes
+	// past the end of the page it starts in but for a delay slot, which bounds the search.
+	u32 lowerstart = addr;
+	bool keptinside = false;
+
+	if (!s_tier2Blocks.empty())
+		lowerstart = addr >= 4 ? (addr - 4) & ~0xfffUL : 0;
+
 	BASEBLOCKEX* pexblock = recBlocks[blockidx + 1];
 	if (pexblock)
 		ceiling = pexblock->startpc;
@@ -798,10 +885,22 @@ void recClear(u32 addr, u32 size)
 		}
 
 		if (blockend <= addr) {
-			lowerextent = std::max(lowerextent, blockend);
-			break;
+			if (blockstart < lowerstart) {
+				lowerextent = std::max(lowerextent, blockend);
+				break;
+			}
+
+			// kept, it may be inside a tier 2 block removed below
+			if(toRemoveLast != blockidx) {
+				recBlocks.Remove((blockidx + 1), toRemoveLast);
+			}
+			toRemoveLast = --blockidx;
+			keptinside = true;
+			continue;
 		}
 
+		recFreeTier2Counter(blockstart);
+
 		lowerextent = std::min(lowerextent, blockstart);
 		upperextent = std::max(upperextent, blockend);
 		// This might end up inside a block that doesn't contain the clearing range,
@@ -830,8 +929,28 @@ void recClear(u32 addr, u32 size)
 		}
 	}
 
-	if (upperextent > lowerextent)
+	if (upperextent > lowerextent) {
 		ClearRecLUT(PC_GETBLOCK(lowerextent), upperextent - lowerextent);
+
+		// The blocks kept inside a removed tier 2 block are still valid, put their entries back
+		// the way recRecompile left them.
+		for (int i = recBlocks.LastIndex(lowerextent); keptinside && (pexblock = recBlocks[i]); i++) {
+			if (pexblock->startpc >= upperextent)
+				break;
+
+			BASEBLOCK* pblock = PC_GETBLOCK(pexblock->startpc);
+
+			if (pexblock->startpc < lowerextent || pblock == s_pCurBlock)
+				continue;
+
+			pblock->SetFnptr(pexblock->fnptr);
+
+			for (u32 j = 1; j < pexblock->size; j++) {
+				if ((uptr)JITCompile == pblock[j].GetFnptr())
+					pblock[j].SetFnptr((uptr)JITCompileInBlock);
+			}
+		}
+	}
 }
 
 
@@ -1493,6 +1612,35 @@ void __fastcall dyna_page_reset(u32 start,u32 sz)
 	mmap_MarkCountedRamPage( start );
 }
 
+// called when the countdown of a tier 1 block reaches zero.  The block is cleared so that
+// it gets recompiled as a tier 2 block, which BaseBlocks::New links in place of the old one.
+void __fastcall dyna_block_promote(u32 start)
+{
+	eeRecPerfLog.Write( Color_StrongGray, "Promoting block @ 0x%08X to tier 2", start);
+	s_tier2Blocks.insert(start);
+	recClear(start, 1);
+}
+
+// Called by recJ/recJAL once the delay slot is compiled: when the analysis of the block
+// followed this jump, compilation continues at the jump target instead of ending the block.
+bool recFollowJump(u32 newpc)
+{
+	// A delay slot which needs a branch test (g_branch == 2) ends the block as usual
+	if (g_branch)
+		return false;
+
+	for (int i = 0; i < s_followedJumpCount; i++) {
+		if (s_followedJumps[i] != pc - 8)
+			continue;
+
+		pc = newpc;
+		g_pCurInstInfo = s_pInstCache + (newpc - s_blockStartPC) / 4;
+		return true;
+	}
+
+	return false;
+}
+
 static void memory_protect_recompiled_code(u32 startpc, u32 size)
 {
 	u32 inpage_ptr = HWADDR(startpc);
@@ -1614,6 +1762,7 @@ static void __fastcall recRecompile( const u32 startpc )
 {
 	u32 i = 0;
 	u32 willbranch3 = 0;
+	u32 segstart;		// start of the part of the block after the last followed jump
 	u32 usecop2;
 
 #ifdef PCSX2_DEBUG
@@ -1700,6 +1849,10 @@ static void __fastcall recRecompile( const u32 startpc )
 		xFastCall((void*)PreBlockCheck, pc);
 	}
 
+	eeBlockProfile* blockProfile = NULL;
+	if (EE::BlockProfiler.IsEnabled())
+		blockProfile = EE::BlockProfiler.EmitBlockEntry(startpc, (uptr)recPtr);
+
 	if (EmuConfig.Gamefixes.GoemonTlbHack) {
 		if (pc == 0x33ad48 || pc == 0x35060c) {
 			// 0x33ad48 and 0x35060c are the return address of the function (0x356250) that populate the TLB cache
@@ -1712,8 +1865,15 @@ static void __fastcall recRecompile( const u32 startpc )
 		}
 	}
 
+	s_blockTier2 = EmuConfig.Cpu.Recompiler.EnableEETier2 && !EmuConfig.Gamefixes.GoemonTlbHack
+		&& s_tier2Blocks.count(HWADDR(startpc));
+	s_blockCanFollow = false;
+	s_blockStartPC = startpc;
+	s_followedJumpCount = 0;
+
 	// go until the next branch
 	i = startpc;
+	segstart = startpc;
 	s_nEndBlock = 0xffffffff;
 	s_branchTo = -1;
 
@@ -1737,7 +1897,7 @@ static void __fastcall recRecompile( const u32 startpc )
 			break;
 		}
 
-		if(i != startpc)	// Block size truncation checks.
+		if(i != startpc && i != segstart)	// Block size truncation checks.
 		{
 			if( (i & 0xffc) == 0x0 )	// breaks blocks at 4k page boundaries
 			{
@@ -1772,7 +1932,7 @@ static void __fastcall recRecompile( const u32 startpc )
 				if( _Rt_ < 4 || (_Rt_ >= 16 && _Rt_ < 20) ) {
 					// branches
 					s_branchTo = _Imm_ * 4 + i + 4;
-					if( s_branchTo > startpc && s_branchTo < i ) s_nEndBlock = s_branchTo;
+					if( s_branchTo > segstart && s_branchTo < i ) s_nEndBlock = s_branchTo;
 					else  s_nEndBlock = i+8;
 
 					goto StartRecomp;
@@ -1783,13 +1943,29 @@ static void __fastcall recRecompile( const u32 startpc )
 			case 3: // JAL
 				s_branchTo = _Target_ << 2 | (i + 4) & 0xf0000000;
 				s_nEndBlock = i + 8;
+
+				// Only forward jumps inside the page, the block stays one range of a page
+				// (the self-modifying code checks and recClear work on ranges).
+				if (EmuConfig.Cpu.Recompiler.EnableEETier2 && !EmuConfig.Gamefixes.GoemonTlbHack
+					&& HWADDR(startpc) < Ps2MemSize::MainRam && s_followedJumpCount < recTier2MaxJumps
+					&& s_branchTo >= i + 8 && (s_branchTo >> 12) == (i >> 12))
+				{
+					if (!s_blockTier2) {
+						s_blockCanFollow = true;
+						goto StartRecomp;
+					}
+
+					s_followedJumps[s_followedJumpCount++] = i;
+					segstart = i = s_branchTo;
+					continue;
+				}
 				goto StartRecomp;
 
 			// branches
 			case 4: case 5: case 6: case 7:
 			case 20: case 21: case 22: case 23:
 				s_branchTo = _Imm_ * 4 + i + 4;
-				if( s_branchTo > startpc && s_branchTo < i ) s_nEndBlock = s_branchTo;
+				if( s_branchTo > segstart && s_branchTo < i ) s_nEndBlock = s_branchTo;
 				else  s_nEndBlock = i+8;
 
 				goto StartRecomp;
@@ -1810,7 +1986,7 @@ static void __fastcall recRecompile( const u32 startpc )
 					// BC1F, BC1T, BC1FL, BC1TL
 					// BC2F, BC2T, BC2FL, BC2TL
 					s_branchTo = _Imm_ * 4 + i + 4;
-					if( s_branchTo > startpc && s_branchTo < i ) s_nEndBlock = s_branchTo;
+					if( s_branchTo > segstart && s_branchTo < i ) s_nEndBlock = s_branchTo;
 					else  s_nEndBlock = i+8;
 
 					goto StartRecomp;
@@ -1833,7 +2009,7 @@ StartRecomp:
 	// without a significant loss in cycle accuracy is with a division, but games would probably
 	// be happy with time wasting loops completing in 0 cycles and timeouts waiting forever.
 	s_nBlockFF = false;
-	if (s_branchTo == startpc) {
+	if (s_branchTo == startpc && !s_followedJumpCount) {
 		s_nBlockFF = true;
 
 		u32 reads = 0, loads = 1;
@@ -1995,6 +2171,16 @@ StartRecomp:
 	// Detect and handle self-modified code
 	memory_protect_recompiled_code(startpc, (s_nEndBlock-startpc) >> 2);
 
+	u32* counter = s_blockCanFollow ? recAllocTier2Counter(HWADDR(startpc)) : NULL;
+
+	if (counter) {
+		xSUB(ptr32[counter], 1);
+		xForwardJNZ8 notHot;
+		xMOV(ecx, HWADDR(startpc));
+		xJMP((void*)DispatchBlockPromote);
+		notHot.SetTarget();
+	}
+
 	// Skip Recompilation if sceMpegIsEnd Pattern detected
 	bool doRecompilation = !skipMPEG_By_Pattern(startpc);
 
@@ -2093,6 +2279,12 @@ StartRecomp:
 	pxAssert(xGetPtr() - recPtr < _64kb);
 	s_pCurBlockEx->x86size = xGetPtr() - recPtr;
 
+	if (blockProfile) {
+		blockProfile->size    = s_pCurBlockEx->size;
+		blockProfile->x86size = s_pCurBlockEx->x86size;
+		blockProfile->cycles  = scaleblockcycles_calculation();
+	}
+
 #if 0
 	// Example: Dump both x86/EE code
 	if (startpc == 0x456630) {
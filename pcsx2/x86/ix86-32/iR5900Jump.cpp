@@ -52,6 +52,8 @@ void recJ()
 	// SET_FPUSTATE;
 	u32 newpc = (_Target_ << 2) + ( pc & 0xf0000000 );
 	recompileNextInstruction(1);
+	if (recFollowJump(newpc))
+		return;
 	if (EmuConfig.Gamefixes.GoemonTlbHack)
 		SetBranchImm(vtlb_V2P(newpc));
 	else
@@ -78,6 +80,8 @@ void recJAL()
 	}
 
 	recompileNextInstruction(1);
+	if (recFollowJump(newpc))
+		return;
 	if (EmuConfig.Gamefixes.GoemonTlbHack)
 		SetBranchImm(vtlb_V2P(newpc));
 	else
@@ -149,8 +149,6 @@ namespace vtlb_private
 	static uptr* DynGen_PrepRegs()
 	{
 		// Warning dirty ebx (in case someone got the very bad idea to move this code)
-		EE::Profiler.EmitMem();
-
 		xMOV( eax, ecx );
 		xSHR( eax, VTLB_PAGE_BITS );
 		xMOV( eax, ptr[(eax*4) + vtlbdata.vmap] );
@@ -162,34 +160,35 @@ namespace vtlb_private
 	}
 
 	// ------------------------------------------------------------------------
-	static void DynGen_DirectRead( u32 bits, bool sign )
+	// ecx - host address, or the EE address when base is eeMem->Main (direct window)
+	static void DynGen_DirectRead( u32 bits, bool sign, const void* base = NULL )
 	{
 		switch( bits )
 		{
 			case 8:
 				if( sign )
-					xMOVSX( eax, ptr8[ecx] );
+					xMOVSX( eax, ptr8[ecx + base] );
 				else
-					xMOVZX( eax, ptr8[ecx] );
+					xMOVZX( eax, ptr8[ecx + base] );
 			break;
 
 			case 16:
 				if( sign )
-					xMOVSX( eax, ptr16[ecx] );
+					xMOVSX( eax, ptr16[ecx + base] );
 				else
-					xMOVZX( eax, ptr16[ecx] );
+					xMOVZX( eax, ptr16[ecx + base] );
 			break;
 
 			case 32:
-				xMOV( eax, ptr[ecx] );
+				xMOV( eax, ptr[ecx + base] );
 			break;
 
 			case 64:
-				iMOV64_Smart( ptr[edx], ptr[ecx] );
+				iMOV64_Smart( ptr[edx], ptr[ecx + base] );
 			break;
 
 			case 128:
-				iMOV128_SSE( ptr[edx], ptr[ecx] );
+				iMOV128_SSE( ptr[edx], ptr[ecx + base] );
 			break;
 
 			jNO_DEFAULT
@@ -197,32 +196,48 @@ namespace vtlb_private
 	}
 
 	// ------------------------------------------------------------------------
-	static void DynGen_DirectWrite( u32 bits )
+	static void DynGen_DirectWrite( u32 bits, const void* base = NULL )
 	{
 		switch(bits)
 		{
 			//8 , 16, 32 : data on EDX
 			case 8:
-				xMOV( ptr[ecx], dl );
+				xMOV( ptr[ecx + base], dl );
 			break;
 
 			case 16:
-				xMOV( ptr[ecx], dx );
+				xMOV( ptr[ecx + base], dx );
 			break;
 
 			case 32:
-				xMOV( ptr[ecx], edx );
+				xMOV( ptr[ecx + base], edx );
 			break;
 
 			case 64:
-				iMOV64_Smart( ptr[ecx], ptr[edx] );
+				iMOV64_Smart( ptr[ecx + base], ptr[edx] );
 			break;
 
 			case 128:
-				iMOV128_SSE( ptr[ecx], ptr[edx] );
+				iMOV128_SSE( ptr[ecx + base], ptr[edx] );
 			break;
 		}
 	}
+
+	// ------------------------------------------------------------------------
+	// Most accesses are to the EE RAM, which games map 1:1 at the bottom of the virtual
+	// space.  The addresses of vtlbdata's direct window are accessed at eeMem->Main + ecx:
+	// unlike the vmap lookup, the window bounds don't depend on the address, so the access
+	// doesn't wait for a vmap load.  Sets the flags for a JAE to the vmap lookup of the other
+	// addresses (eax is clobbered, the vmap lookup does it too).
+	//
+	static void DynGen_DirectWindowCheck()
+	{
+		EE::Profiler.EmitMem();
+
+		xMOV( eax, ecx );
+		xSUB( eax, ptr32[&vtlbdata.directStart] );
+		xCMP( eax, ptr32[&vtlbdata.directSize] );
+	}
 }
 
 // ------------------------------------------------------------------------
@@ -344,12 +359,19 @@ void vtlb_DynGenRead64(u32 bits)
 {
 	pxAssume( bits == 64 || bits == 128 );
 
+	DynGen_DirectWindowCheck();
+	xForwardJAE8 notDirect;
+	DynGen_DirectRead( bits, false, eeMem->Main );
+	xForwardJump8 done;
+	notDirect.SetTarget();
+
 	uptr* writeback = DynGen_PrepRegs();
 
 	DynGen_IndirectDispatch( 0, bits );
 	DynGen_DirectRead( bits, false );
 
 	*writeback = (uptr)xGetPtr();		// return target for indirect's call/ret
+	done.SetTarget();
 }
 
 // ------------------------------------------------------------------------
@@ -360,12 +382,19 @@ void vtlb_DynGenRead32(u32 bits, bool sign)
 {
 	pxAssume( bits <= 32 );
 
+	DynGen_DirectWindowCheck();
+	xForwardJAE8 notDirect;
+	DynGen_DirectRead( bits, sign, eeMem->Main );
+	xForwardJump8 done;
+	notDirect.SetTarget();
+
 	uptr* writeback = DynGen_PrepRegs();
 
 	DynGen_IndirectDispatch( 0, bits, sign && bits < 32 );
 	DynGen_DirectRead( bits, sign );
 
 	*writeback = (uptr)xGetPtr();
+	done.SetTarget();
 }
 
 // ------------------------------------------------------------------------
@@ -496,12 +525,19 @@ void vtlb_DynGenRead32_Const( u32 bits, bool sign, u32 addr_const )
 
 void vtlb_DynGenWrite(u32 sz)
 {
+	DynGen_DirectWindowCheck();
+	xForwardJAE8 notDirect;
+	DynGen_DirectWrite( sz, eeMem->Main );
+	xForwardJump8 done;
+	notDirect.SetTarget();
+
 	uptr* writeback = DynGen_PrepRegs();
 
 	DynGen_IndirectDispatch( 1, sz );
 	DynGen_DirectWrite( sz );
 
 	*writeback = (uptr)xGetPtr();
+	done.SetTarget();
 }
 
 
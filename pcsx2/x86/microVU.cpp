@@ -62,6 +62,7 @@ void mVUinit(microVU& mVU, uint vuIndex) {
 	mVU.dispCache		= NULL;
 	mVU.startFunct		= NULL;
 	mVU.exitFunct		= NULL;
+	mVU.cacheCRC		= 0;
 
 	mVUreserveCache(mVU);
 
@@ -74,6 +75,15 @@ void mVUinit(microVU& mVU, uint vuIndex) {
 // Resets Rec Data
 void mVUreset(microVU& mVU, bool resetReserve) {
 
+	// On a full reset, keep what was compiled for next time; the game may change, so the
+	// cache will be reloaded by the next execution.  A reset because the rec-cache is full
+	// happens mid-game: it neither saves (no disk writes on the VU thread while the game
+	// runs) nor reloads the cache (that would just fill it up again).
+	if (resetReserve) {
+		mVUsaveProgCache(mVU);
+		mVU.cacheCRC = 0;
+	}
+
 	// Restore reserve to uncommitted state
 	if (resetReserve) mVU.cache_reserve->Reset();
 
@@ -127,6 +137,7 @@ void mVUreset(microVU& mVU, bool resetReserve) {
 // Free Allocated Resources
 void mVUclose(microVU& mVU) {
 
+	mVUsaveProgCache(mVU);
 	safe_delete  (mVU.cache_reserve);
 
 	// Delete Programs and Block Managers
@@ -36,6 +36,9 @@ using namespace x86Emitter;
 #include "microVU_IR.h"
 #include "microVU_Profiler.h"
 #include "Utilities/Perf.h"
+#include "Elfheader.h"
+#include "AppConfig.h"
+#include <wx/ffile.h>
 
 struct microBlockLink {
 	microBlock		block;
@@ -118,6 +121,11 @@ public:
 		}
 		return NULL;
 	}
+	template<typename Func>
+	void forEach(Func func) { // Calls func(microBlock&) for every block
+		for(microBlockLink* linkI = qBlockList; linkI != NULL; linkI = linkI->next) func(linkI->block);
+		for(microBlockLink* linkI = fBlockList; linkI != NULL; linkI = linkI->next) func(linkI->block);
+	}
 	void printInfo(int pc, bool printQuick) {
 		int listI = printQuick ? qListI : fListI;
 		if (listI < 7) return;
@@ -218,6 +226,7 @@ struct microVU {
 	u32		q;			  // Holds current Q instance index
 	u32		totalCycles;  // Total Cycles that mVU is expected to run for
 	u32		cycles;		  // Cycles Counter
+	u32		cacheCRC;	  // Game CRC the persistent program cache is loaded for (0 = none)
 
 	VURegs& regs() const { return ::vuRegs[index]; }
 
@@ -250,6 +259,10 @@ mVUop(mVUopL);
 // Private Functions
 extern void  mVUcacheProg (microVU& mVU, microProgram&  prog);
 extern void  mVUdeleteProg(microVU& mVU, microProgram*& prog);
+extern microProgram* mVUcreateProg(microVU& mVU, int startPC);
+extern u64   mVUrangesHash(microVU& mVU, microProgram& prog);
+extern void  mVUsaveProgCache(microVU& mVU);
+extern void  mVUloadProgCache(microVU& mVU);
 _mVUt extern void* mVUsearchProg(u32 startPC, uptr pState);
 extern void* __fastcall mVUexecuteVU0(u32 startPC, u32 cycles);
 extern void* __fastcall mVUexecuteVU1(u32 startPC, u32 cycles);
@@ -280,5 +293,6 @@ void sortVector(T& v) {
 #include "microVU_Flags.inl"
 #include "microVU_Branch.inl"
 #include "microVU_Compile.inl"
+#include "microVU_Cache.inl"
 #include "microVU_Execute.inl"
 #include "microVU_Macro.inl"
@@ -0,0 +1,245 @@
+/*  PCSX2 - PS2 Emulator for PCs
+ *  Copyright (C) 2002-2010  PCSX2 Dev Team
+ *
+ *  PCSX2 is free software: you can redistribute it and/or modify it under the terms
+ *  of the GNU Lesser General Public License as published by the Free Software Found-
+ *  ation, either version 3 of the License, or (at your option) any later version.
+ *
+ *  PCSX2 is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ *  without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ *  PURPOSE.  See the GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along with PCSX2.
+ *  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+//------------------------------------------------------------------
+// Persistent microProgram Cache
+//------------------------------------------------------------------
+// The recompiled x86 code itself can't be reused by another session: it's full of absolute
+// addresses (block managers, jump caches, other blocks of the rec-cache).  So what gets saved
+// per game is what's needed to compile it again: the recompiled ranges of each microProgram
+// and the pipeline states its blocks were entered with.  When the game starts again, all of
+// those programs are recompiled up front, and mVUsearchProg finds them already compiled
+// when the game uploads them instead of compiling them mid-game.
+//
+// File layout (one file per VU and per game CRC):
+//   header: magic, version, vu index, options key, sizeof(microRegInfo), program count
+//   per program: startPC, range count, ranges, the range's micro memory words, block
+//                count, and for each block its PC and starting pipeline state
+
+static const u32 mVUcacheMagic		= 0x4355564d; // "MVUC"
+static const u32 mVUcacheVersion	= 2;
+static const u32 mVUcacheMaxProgs	= 1024;		  // Per VU and game, keeps startup compile time sane
+
+// Options which affect how blocks get compiled; a cache saved with other options is ignored.
+// Only the VU ones count, so toggling an EE/IOP option or the caches doesn't throw it away.
+static u32 mVUcacheOptionsKey(microVU& mVU) {
+	const Pcsx2Config::RecompilerOptions& rec = EmuConfig.Cpu.Recompiler;
+	u32 key = 0;
+	key |= rec.EnableVU0			<< 0;
+	key |= rec.EnableVU1			<< 1;
+	key |= rec.UseMicroVU0			<< 2;
+	key |= rec.UseMicroVU1			<< 3;
+	key |= rec.vuOverflow			<< 4;
+	key |= rec.vuExtraOverflow		<< 5;
+	key |= rec.vuSignOverflow		<< 6;
+	key |= rec.vuUnderflow			<< 7;
+	key |= CHECK_VU_FLAGHACK		<< 8;
+	key |= THREAD_VU1				<< 9;
+	key |= CHECK_VUADDSUBHACK		<< 10;
+	key |= CHECK_XGKICKHACK			<< 11;
+	key |= EmuConfig.Gamefixes.ScarfaceIbit << 12;
+	return key ^ (EmuConfig.Cpu.sseVUMXCSR.bitmask << 16); // rounding mode, DaZ, FtZ
+}
+
+static wxString mVUcacheFilename(microVU& mVU, u32 crc) {
+	wxDirName folder(PathDefs::GetDocuments() + wxDirName(L"cache"));
+	folder.Mkdir();
+	return (folder + wxsFormat(L"microVU%d_%08X.cache", mVU.index, crc)).GetFullPath();
+}
+
+// Micro memory words a range depends on (mVUcmpPartial checks up to end+8)
+static __fi void mVUcacheRangeWords(microVU& mVU, const microRange& range, u32& first, u32& last) {
+	first = range.start / 4;
+	last  = std::min<u32>(range.end + 8, mVU.microMemSize) / 4;
+}
+
+// Saves the programs of the game the cache is currently loaded for
+void mVUsaveProgCache(microVU& mVU) {
+	if (!mVU.cacheCRC || !EmuConfig.Cpu.Recompiler.EnableVUCache) return;
+
+	std::vector<u8> out;
+	auto write = [&](const void* src, size_t size) {
+		out.insert(out.end(), (const u8*)src, (const u8*)src + size);
+	};
+	auto write32 = [&](u32 value) { write(&value, sizeof(value)); };
+
+	const u32 header[] = { mVUcacheMagic, mVUcacheVersion, mVU.index, mVUcacheOptionsKey(mVU), sizeof(microRegInfo), 0 };
+	write(header, sizeof(header));
+
+	// Lists are most recently used first, so if there are too many programs the ones
+	// which are dropped are the least used.  Identical programs are saved only once.
+	std::vector<std::pair<u32, u64>> saved;
+	u32 progCount = 0;
+
+	for (u32 pc = 0; pc < (mVU.progSize / 2) && progCount < mVUcacheMaxProgs; pc++) {
+		microProgramList* list = mVU.prog.prog[pc];
+		if (!list) continue;
+		std::deque<microProgram*>::iterator it(list->begin());
+		for ( ; it != list->end() && progCount < mVUcacheMaxProgs; ++it) {
+			microProgram& prog = *it[0];
+			if (prog.ranges->empty()) continue;
+
+			bool validRanges = true;
+			std::deque<microRange>::const_iterator rIt(prog.ranges->begin());
+			for ( ; rIt != prog.ranges->end(); ++rIt) {
+				if ((rIt[0].start < 0) || (rIt[0].end < rIt[0].start)) validRanges = false;
+			}
+			if (!validRanges) continue;
+
+			const std::pair<u32, u64> key(prog.startPC, mVUrangesHash(mVU, prog));
+			if (std::find(saved.begin(), saved.end(), key) != saved.end()) continue;
+			saved.push_back(key);
+
+			write32(prog.startPC);
+			write32(prog.ranges->size());
+			for (rIt = prog.ranges->begin(); rIt != prog.ranges->end(); ++rIt) {
+				u32 first, last;
+				mVUcacheRangeWords(mVU, rIt[0], first, last);
+				write32(rIt[0].start);
+				write32(rIt[0].end);
+				write(&prog.data[first], (last - first) * 4);
+			}
+
+			const size_t blockCountPos = out.size();
+			u32 blockCount = 0;
+			write32(0);
+			for (u32 i = 0; i < (mVU.progSize / 2); i++) {
+				if (!prog.block[i]) continue;
+				prog.block[i]->forEach([&](microBlock& block) {
+					write32(i * 8);
+					write(&block.pState, sizeof(microRegInfo));
+					blockCount++;
+				});
+			}
+			memcpy(&out[blockCountPos], &blockCount, sizeof(blockCount));
+			progCount++;
+		}
+	}
+
+	if (!progCount) return;
+	memcpy(&out[sizeof(header) - sizeof(u32)], &progCount, sizeof(progCount));
+
+	const wxString filename(mVUcacheFilename(mVU, mVU.cacheCRC));
+	wxFFile file(filename, L"wb");
+	if (!file.IsOpened() || (file.Write(out.data(), out.size()) != out.size())) {
+		Console.Warning(L"microVU%d: Failed to save the program cache to '%s'", mVU.index, WX_STR(filename));
+		return;
+	}
+	DevCon.WriteLn(mVU.index ? Color_Orange : Color_Magenta, "microVU%d: Saved %d programs to the program cache [%08x]",
+				   mVU.index, progCount, mVU.cacheCRC);
+}
+
+// Recompiles the programs saved for the current game.  Must run on the thread executing the
+// VU, with the emitter set to mVU.prog.x86ptr (see mVUexecute).
+void mVUloadProgCache(microVU& mVU) {
+	if (!mVU.cacheCRC || !EmuConfig.Cpu.Recompiler.EnableVUCache) return;
+
+	const wxString filename(mVUcacheFilename(mVU, mVU.cacheCRC));
+	if (!wxFileExists(filename)) return;
+
+	std::vector<u8> in;
+	{
+		wxFFile file(filename, L"rb");
+		if (!file.IsOpened()) return;
+		in.resize(file.Length());
+		if (in.empty() || (file.Read(in.data(), in.size()) != in.size())) return;
+	}
+
+	size_t pos = 0;
+	auto read = [&](void* dest, size_t size) {
+		if (in.size() - pos < size) return false;
+		memcpy(dest, &in[pos], size);
+		pos += size;
+		return true;
+	};
+
+	u32 header[6];
+	if (!read(header, sizeof(header)) || (header[0] != mVUcacheMagic) || (header[1] != mVUcacheVersion)
+	|| (header[2] != mVU.index) || (header[3] != mVUcacheOptionsKey(mVU)) || (header[4] != sizeof(microRegInfo))) {
+		DevCon.WriteLn(mVU.index ? Color_Orange : Color_Magenta, "microVU%d: Program cache [%08x] is outdated, ignoring it", mVU.index, mVU.cacheCRC);
+		return;
+	}
+
+	const u64 startTime = GetCPUTicks();
+	const u32 progCount = std::min(header[5], mVUcacheMaxProgs);
+
+	// Compile from the saved program data, then put back the real micro memory
+	std::unique_ptr<u8[]> microBackup(new u8[mVU.microMemSize]);
+	memcpy(microBackup.get(), mVU.regs().Micro, mVU.microMemSize);
+
+	// Leave at least half of the rec-cache to the programs compiled during the game
+	u8* x86limit = mVU.prog.x86start + (mVU.prog.x86end - mVU.prog.x86start) / 2;
+
+	bool valid = true;
+	u32  loaded = 0;
+	for ( ; loaded < progCount && valid && (xGetPtr() < x86limit); loaded++) {
+		u32 startPC, rangeCount;
+		valid = read(&startPC, 4) && read(&rangeCount, 4) && (startPC < (mVU.progSize / 2)) && (rangeCount <= mVU.progSize);
+		if (!valid) break;
+
+		memset(mVU.regs().Micro, 0, mVU.microMemSize);
+		for (u32 i = 0; i < rangeCount && valid; i++) {
+			microRange range;
+			valid = read(&range.start, 4) && read(&range.end, 4)
+				&& (range.start >= 0) && (range.end >= range.start) && ((u32)range.end <= mVU.microMemSize);
+			if (!valid) break;
+			u32 first, last;
+			mVUcacheRangeWords(mVU, range, first, last);
+			valid = read(&((u32*)mVU.regs().Micro)[first], (last - first) * 4);
+		}
+
+		u32 blockCount;
+		valid = valid && read(&blockCount, 4);
+		if (!valid) break;
+
+		mVU.prog.cleared = 0;
+		mVU.prog.isSame  = 1;
+		mVU.prog.cur     = mVUcreateProg(mVU, startPC);
+		mVU.prog.prog[startPC]->push_back(mVU.prog.cur); // Least recently used, until the game uses it
+
+		for (u32 i = 0; i < blockCount; i++) {
+			u32 pc;
+			microRegInfo pState;
+			valid = read(&pc, 4) && read(&pState, sizeof(pState)) && !(pc & 7) && (pc <= mVU.microMemSize - 8);
+			if (!valid) break;
+			mVUblockFetch(mVU, pc, (uptr)&pState);
+		}
+	}
+
+	memcpy(mVU.regs().Micro, microBackup.get(), mVU.microMemSize);
+
+	// Next execution searches the program lists again
+	mVU.prog.cleared = 1;
+	mVU.prog.isSame  = -1;
+	mVU.prog.cur     = NULL;
+	for (u32 i = 0; i < (mVU.progSize / 2); i++) {
+		mVU.prog.quick[i].block = NULL;
+		mVU.prog.quick[i].prog  = NULL;
+	}
+
+	if (!valid) Console.Warning(L"microVU%d: Program cache '%s' is corrupted, loaded only %d programs", mVU.index, WX_STR(filename), loaded);
+	Console.WriteLn(mVU.index ? Color_Orange : Color_Magenta, "microVU%d: Recompiled %d cached programs in %d ms",
+					mVU.index, loaded, (int)((GetCPUTicks() - startTime) * 1000 / GetTickFrequency()));
+}
+
+// Called when the game changes: saves the programs of the previous one and recompiles the
+// ones saved for the new one.
+void mVUswitchProgCache(microVU& mVU, u32 crc) {
+	mVUsaveProgCache(mVU);
+	mVU.cacheCRC = crc;
+	mVUloadProgCache(mVU);
+}
@@ -130,6 +130,7 @@ _mVUt void* __fastcall mVUexecute(u32 startPC, u32 cycles) {
 	mVU.totalCycles = cycles;
 
 	xSetPtr(mVU.prog.x86ptr); // Set x86ptr to where last program left off
+	if (mVU.cacheCRC != ElfCRC) mVUswitchProgCache(mVU, ElfCRC); // Game changed, see microVU_Cache.inl
 	return mVUsearchProg<vuIndex>(startPC & vuLimit, (uptr)&mVU.prog.lpState); // Find and set correct program
 }
 
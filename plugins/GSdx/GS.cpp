@@ -985,6 +985,15 @@ EXPORT_C GSsetExclusive(int enabled)
 	}
 }
 
+// First frame played by GSReplay. With a keyframed dump (.gsk) the replay starts from the
+// closest keyframe instead of the beginning of the dump.
+static uint32 s_replay_start_frame = 0;
+
+EXPORT_C GSReplayStartFrame(int frame)
+{
+	s_replay_start_frame = std::max(frame, 0);
+}
+
 #ifdef _WIN32
 
 #include <io.h>
@@ -1079,10 +1088,25 @@ EXPORT_C GSReplay(HWND hwnd, HINSTANCE hinst, LPSTR lpszCmdLine, int nCmdShow)
 
 	const std::string f{lpszCmdLine};
 	const bool is_xz = f.size() >= 4 && f.compare(f.size() - 3, 3, ".xz") == 0;
+	const bool is_gsk = f.size() >= 5 && f.compare(f.size() - 4, 4, ".gsk") == 0;
+
+	uint32 first_frame = 0;
+	std::unique_ptr<GSDumpFile> file;
 
-	auto file = is_xz
-		? std::unique_ptr<GSDumpFile>{std::make_unique<GSDumpLzma>(lpszCmdLine, nullptr)}
-		: std::unique_ptr<GSDumpFile>{std::make_unique<GSDumpRaw>(lpszCmdLine, nullptr)};
+	if(is_gsk)
+	{
+		auto gsk = std::make_unique<GSDumpKeyframedFile>(lpszCmdLine, nullptr, s_replay_start_frame);
+		first_frame = gsk->GetFirstFrame();
+		file = std::move(gsk);
+	}
+	else if(is_xz)
+	{
+		file = std::make_unique<GSDumpLzma>(lpszCmdLine, nullptr);
+	}
+	else
+	{
+		file = std::make_unique<GSDumpRaw>(lpszCmdLine, nullptr);
+	}
 
 	GSinit();
 
@@ -1159,32 +1183,59 @@ EXPORT_C GSReplay(HWND hwnd, HINSTANCE hinst, LPSTR lpszCmdLine, int nCmdShow)
 	Sleep(100);
 
 	std::vector<uint8> buff;
+
+	auto play = [&](Packet& p) {
+		switch(p.type)
+		{
+		case 0:
+			switch(p.param)
+			{
+			case 0: GSgifTransfer1(p.buff.data(), p.addr); break;
+			case 1: GSgifTransfer2(p.buff.data(), p.size / 16); break;
+			case 2: GSgifTransfer3(p.buff.data(), p.size / 16); break;
+			case 3: GSgifTransfer(p.buff.data(), p.size / 16); break;
+			}
+			break;
+		case 1:
+			GSvsync(p.param);
+			break;
+		case 2:
+			if(buff.size() < p.size) buff.resize(p.size);
+			GSreadFIFO2(p.buff.data(), p.size / 16);
+			break;
+		case 3:
+			memcpy(regs.data(), p.buff.data(), 0x2000);
+			break;
+		}
+	};
+
+	// Frames before the start frame are only played once, to reach its state
+
+	uint32 frame = first_frame;
+
+	for(; frame < s_replay_start_frame && !packets.empty(); packets.pop_front())
+	{
+		play(packets.front());
+
+		if(packets.front().type == 1)
+			frame++;
+	}
+
+	if(packets.empty())
+	{
+		printf("GSdx: start frame %u is past the end of the dump (%u frames)\n", s_replay_start_frame, frame);
+
+		GSclose();
+		GSshutdown();
+
+		return;
+	}
+
 	while(IsWindowVisible(hWnd))
 	{
 		for(auto &p : packets)
 		{
-			switch(p.type)
-			{
-			case 0:
-				switch(p.param)
-				{
-				case 0: GSgifTransfer1(p.buff.data(), p.addr); break;
-				case 1: GSgifTransfer2(p.buff.data(), p.size / 16); break;
-				case 2: GSgifTransfer3(p.buff.data(), p.size / 16); break;
-				case 3: GSgifTransfer(p.buff.data(), p.size / 16); break;
-				}
-				break;
-			case 1:
-				GSvsync(p.param);
-				break;
-			case 2:
-				if(buff.size() < p.size) buff.resize(p.size);
-				GSreadFIFO2(p.buff.data(), p.size / 16);
-				break;
-			case 3:
-				memcpy(regs.data(), p.buff.data(), 0x2000);
-				break;
-			}
+			play(p);
 		}
 	}
 
@@ -1408,6 +1459,158 @@ inline unsigned long timeGetTime()
 	return (unsigned long)(t.tv_sec*1000 + t.tv_nsec/1000000);
 }
 
+struct GSReplayPacket {uint8 type, param; uint32 size, addr; std::vector<uint8> buff;};
+
+// Load a .gs/.gs.xz/.gsk dump into packets. The GS must be opened beforehand as the
+// embedded state is directly frozen into it. Return the number of frames read.
+// first_frame receives the frame the packets start at, the keyframe of a .gsk dump.
+static long GSReplayLoad(char* lpszCmdLine, std::list<GSReplayPacket*>& packets, uint8* regs, bool repack_dump, long max_frame, uint32* first_frame = NULL)
+{
+	long frame_number = 0;
+
+	std::string f(lpszCmdLine);
+	bool is_xz = (f.size() >= 4) && (f.compare(f.size()-3, 3, ".xz") == 0);
+	bool is_gsk = (f.size() >= 5) && (f.compare(f.size()-4, 4, ".gsk") == 0);
+	if (is_xz)
+		f.replace(f.end()-6, f.end(), "_repack.gs");
+	else if (is_gsk)
+		f.replace(f.end()-4, f.end(), "_repack.gs");
+	else
+		f.replace(f.end()-3, f.end(), "_repack.gs");
+
+	GSDumpFile* file;
+
+	if (is_gsk)
+	{
+		GSDumpKeyframedFile* gsk = new GSDumpKeyframedFile(lpszCmdLine, repack_dump ? f.c_str() : nullptr, s_replay_start_frame);
+
+		if (first_frame)
+			*first_frame = gsk->GetFirstFrame();
+
+		file = gsk;
+	}
+	else
+	{
+		file = is_xz
+			? (GSDumpFile*) new GSDumpLzma(lpszCmdLine, repack_dump ? f.c_str() : nullptr)
+			: (GSDumpFile*) new GSDumpRaw(lpszCmdLine, repack_dump ? f.c_str() : nullptr);
+
+		if (first_frame)
+			*first_frame = 0;
+	}
+
+	uint32 crc;
+	file->Read(&crc, 4);
+	GSsetGameCRC(crc, 0);
+
+	GSFreezeData fd;
+	file->Read(&fd.size, 4);
+	fd.data = new uint8[fd.size];
+	file->Read(fd.data, fd.size);
+
+	GSfreeze(FREEZE_LOAD, &fd);
+	delete [] fd.data;
+
+	file->Read(regs, 0x2000);
+
+	uint8 type;
+	while(file->Read(&type, 1))
+	{
+		GSReplayPacket* p = new GSReplayPacket();
+
+		p->type = type;
+
+		switch(type)
+		{
+		case 0:
+			file->Read(&p->param, 1);
+			file->Read(&p->size, 4);
+
+			switch(p->param)
+			{
+			case 0:
+				p->buff.resize(0x4000);
+				p->addr = 0x4000 - p->size;
+				file->Read(&p->buff[p->addr], p->size);
+				break;
+			case 1:
+			case 2:
+			case 3:
+				p->buff.resize(p->size);
+				file->Read(&p->buff[0], p->size);
+				break;
+			}
+
+			break;
+
+		case 1:
+			file->Read(&p->param, 1);
+			frame_number++;
+
+			break;
+
+		case 2:
+			file->Read(&p->size, 4);
+
+			break;
+
+		case 3:
+			p->buff.resize(0x2000);
+
+			file->Read(&p->buff[0], 0x2000);
+
+			break;
+		}
+
+		packets.push_back(p);
+
+		if (max_frame > 0 && frame_number > max_frame)
+			break;
+	}
+
+	delete file;
+
+	return frame_number;
+}
+
+static void GSReplayPacketPlay(GSReplayPacket* p, std::vector<uint8>& buff, uint8* regs)
+{
+	switch(p->type)
+	{
+		case 0:
+
+			switch(p->param)
+			{
+				case 0: GSgifTransfer1(&p->buff[0], p->addr); break;
+				case 1: GSgifTransfer2(&p->buff[0], p->size / 16); break;
+				case 2: GSgifTransfer3(&p->buff[0], p->size / 16); break;
+				case 3: GSgifTransfer(&p->buff[0], p->size / 16); break;
+			}
+
+			break;
+
+		case 1:
+
+			GSvsync(p->param);
+
+			break;
+
+		case 2:
+
+			if(buff.size() < p->size) buff.resize(p->size);
+
+			GSreadFIFO2(&buff[0], p->size / 16);
+
+			break;
+
+		case 3:
+
+			memcpy(regs, &p->buff[0], 0x2000);
+
+			break;
+	}
+}
+
 // Note
 EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 {
@@ -1427,9 +1630,7 @@ EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 		return;
 	}
 
-	struct Packet {uint8 type, param; uint32 size, addr; std::vector<uint8> buff;};
-
-	std::list<Packet*> packets;
+	std::list<GSReplayPacket*> packets;
 	std::vector<uint8> buff;
 	uint8 regs[0x2000];
 
@@ -1454,170 +1655,317 @@ EXPORT_C GSReplay(char* lpszCmdLine, int renderer)
 	}
 	if (s_gs->m_wnd == NULL) return;
 
-	{ // Read .gs content
-		std::string f(lpszCmdLine);
-		bool is_xz = (f.size() >= 4) && (f.compare(f.size()-3, 3, ".xz") == 0);
-		if (is_xz)
-			f.replace(f.end()-6, f.end(), "_repack.gs");
-		else
-			f.replace(f.end()-3, f.end(), "_repack.gs");
+	// Read .gs content
+	uint32 first_frame = 0;
+	GSReplayLoad(lpszCmdLine, packets, regs, repack_dump, repack_dump ? -finished : 0, &first_frame);
 
-		GSDumpFile* file = is_xz
-			? (GSDumpFile*) new GSDumpLzma(lpszCmdLine, repack_dump ? f.c_str() : nullptr)
-			: (GSDumpFile*) new GSDumpRaw(lpszCmdLine, repack_dump ? f.c_str() : nullptr);
+	sleep(2);
 
-		uint32 crc;
-		file->Read(&crc, 4);
-		GSsetGameCRC(crc, 0);
 
-		GSFreezeData fd;
-		file->Read(&fd.size, 4);
-		fd.data = new uint8[fd.size];
-		file->Read(fd.data, fd.size);
+	frame_number = 0;
 
-		GSfreeze(FREEZE_LOAD, &fd);
-		delete [] fd.data;
+	// Init vsync stuff
+	GSvsync(1);
 
-		file->Read(regs, 0x2000);
+	// Frames before the start frame are only played once, to reach its state
+	uint32 frame = first_frame;
 
-		uint8 type;
-		while(file->Read(&type, 1))
-		{
-			Packet* p = new Packet();
+	while(frame < s_replay_start_frame && !packets.empty())
+	{
+		GSReplayPacket* p = packets.front();
 
-			p->type = type;
+		GSReplayPacketPlay(p, buff, regs);
 
-			switch(type)
-			{
-			case 0:
-				file->Read(&p->param, 1);
-				file->Read(&p->size, 4);
+		if(p->type == 1)
+			frame++;
 
-				switch(p->param)
-				{
-				case 0:
-					p->buff.resize(0x4000);
-					p->addr = 0x4000 - p->size;
-					file->Read(&p->buff[p->addr], p->size);
-					break;
-				case 1:
-				case 2:
-				case 3:
-					p->buff.resize(p->size);
-					file->Read(&p->buff[0], p->size);
-					break;
-				}
+		packets.pop_front();
+		delete p;
+	}
 
-				break;
+	if (packets.empty()) {
+		fprintf(stderr, "Start frame %u is past the end of the dump (%u frames)\n", s_replay_start_frame, frame);
 
-			case 1:
-				file->Read(&p->param, 1);
+		GSclose();
+		GSshutdown();
+		return;
+	}
+
+	while(finished > 0)
+	{
+		for(auto i = packets.begin(); i != packets.end(); i++)
+		{
+			GSReplayPacket* p = *i;
+
+			GSReplayPacketPlay(p, buff, regs);
+
+			if(p->type == 1)
 				frame_number++;
+		}
 
-				break;
+		if (finished >= 200) {
+			; // Nop for Nvidia Profiler
+		} else if (finished > 90) {
+			sleep(1);
+		} else {
+			finished--;
+		}
+	}
 
-			case 2:
-				file->Read(&p->size, 4);
+	static_cast<GSDeviceOGL*>(s_gs->m_dev)->GenerateProfilerData();
 
-				break;
+#ifdef ENABLE_OGL_DEBUG_MEM_BW
+	unsigned long total_frame_nb = std::max(1l, frame_number) << 10;
+	fprintf(stderr, "memory bandwith. T: %f KB/f. V: %f KB/f. U: %f KB/f\n",
+			(float)g_real_texture_upload_byte/(float)total_frame_nb,
+			(float)g_vertex_upload_byte/(float)total_frame_nb,
+			(float)g_uniform_upload_byte/(float)total_frame_nb
+		   );
+#endif
 
-			case 3:
-				p->buff.resize(0x2000);
+	for(auto i = packets.begin(); i != packets.end(); i++)
+	{
+		delete *i;
+	}
 
-				file->Read(&p->buff[0], 0x2000);
+	packets.clear();
 
-				break;
-			}
+	sleep(2);
+
+	GSclose();
+	GSshutdown();
+}
 
-			packets.push_back(p);
+static inline uint64 GSReplayNow()
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64)t.tv_sec * 1000000000ull + (uint64)t.tv_nsec;
+}
 
-			if (repack_dump && frame_number > -finished)
-				break;
+// Quotes s as a JSON string
+static std::string GSReplayJsonString(const char* s)
+{
+	std::string out = "\"";
+
+	for (; *s; s++)
+	{
+		unsigned char c = (unsigned char)*s;
+
+		switch (c)
+		{
+		case '"': out += "\\\""; break;
+		case '\\': out += "\\\\"; break;
+		case '\b': out += "\\b"; break;
+		case '\f': out += "\\f"; break;
+		case '\n': out += "\\n"; break;
+		case '\r': out += "\\r"; break;
+		case '\t': out += "\\t"; break;
+		default:
+			if (c < 0x20)
+				out += format("\\u%04x", c);
+			else
+				out += (char)c;
+			break;
 		}
+	}
+
+	return out + "\"";
+}
 
-		delete file;
+// Headless benchmark: play the dump `loops` times without any window, through
+// either the SW renderer (renderer == OGL_SW) or the Null renderer, and print
+// per-frame timing and GSPerfMon counters. A JSON summary is written to
+// json_path when it isn't NULL.
+EXPORT_C GSBenchmarkReplay(char* lpszCmdLine, int renderer, int loops, const char* json_path)
+{
+	GSRendererType type = static_cast<GSRendererType>(renderer);
+
+	if (type != GSRendererType::OGL_SW && type != GSRendererType::Null)
+	{
+		fprintf(stderr, "GSBenchmarkReplay: only the SW (%d) and Null (%d) renderers are supported\n",
+			static_cast<int>(GSRendererType::OGL_SW), static_cast<int>(GSRendererType::Null));
+		return;
 	}
 
-	sleep(2);
+	if (GSinit() != 0)
+		return;
 
+	std::list<GSReplayPacket*> packets;
+	std::vector<uint8> buff;
+	uint8 regs[0x2000];
 
-	frame_number = 0;
+	GSsetBaseMem(regs);
+
+	int threads = theApp.GetConfigI("extrathreads");
+
+	// Don't go through _GSopen, it always wants a real window.
+	theApp.SetCurrentRendererType(type);
+
+	// Both draw into a null device, only the renderer tells them apart
+	const char* renderer_name = type == GSRendererType::OGL_SW ? "Software" : "Null";
+
+	if (type == GSRendererType::OGL_SW)
+	{
+		s_gs = new GSRendererSW(threads);
+		s_renderer_type = " SW";
+	}
+	else
+	{
+		s_gs = new GSRendererNull();
+		s_renderer_type = " Null";
+	}
+
+	s_renderer_name = "";
+	s_gs->m_wnd = std::make_shared<GSWndNull>();
+	s_gs->SetRegsMem(s_basemem);
+	s_gs->SetIrqCallback(s_irq);
+	s_gs->SetVSync(0);
+
+	if (!s_gs->CreateDevice(new GSDeviceNull()))
+	{
+		fprintf(stderr, "GSBenchmarkReplay: failed to create the null device\n");
+		GSclose();
+		GSshutdown();
+		return;
+	}
+
+	long dump_frames = GSReplayLoad(lpszCmdLine, packets, regs, false, 0);
+
+	if (dump_frames == 0)
+	{
+		fprintf(stderr, "GSBenchmarkReplay: %s doesn't contain any frame\n", lpszCmdLine);
+	}
+
+	loops = std::max(loops, 1);
+
+	std::vector<double> frames; // in ms
+	frames.reserve(dump_frames * loops);
+
+	GSPerfMon& pm = s_gs->m_perfmon;
 
-	// Init vsync stuff
 	GSvsync(1);
 
-	while(finished > 0)
+	pm.ResetAccumulated();
+
+	uint64 tsc_start = __rdtsc();
+	uint64 start = GSReplayNow();
+	uint64 last = start;
+
+	for (int loop = 0; loop < loops; loop++)
 	{
-		for(auto i = packets.begin(); i != packets.end(); i++)
+		for (auto i = packets.begin(); i != packets.end(); i++)
 		{
-			Packet* p = *i;
+			GSReplayPacket* p = *i;
 
-			switch(p->type)
+			GSReplayPacketPlay(p, buff, regs);
+
+			if (p->type == 1)
 			{
-				case 0:
+				uint64 now = GSReplayNow();
+				frames.push_back((now - last) / 1e6);
+				last = now;
+			}
+		}
+	}
 
-					switch(p->param)
-					{
-						case 0: GSgifTransfer1(&p->buff[0], p->addr); break;
-						case 1: GSgifTransfer2(&p->buff[0], p->size / 16); break;
-						case 2: GSgifTransfer3(&p->buff[0], p->size / 16); break;
-						case 3: GSgifTransfer(&p->buff[0], p->size / 16); break;
-					}
+	uint64 tsc_elapsed = std::max<uint64>(__rdtsc() - tsc_start, 1);
+	double total_ms = (GSReplayNow() - start) / 1e6;
 
-					break;
+	double min = 0, avg = 0, p99 = 0, max = 0;
 
-				case 1:
+	if (!frames.empty())
+	{
+		std::vector<double> sorted(frames);
+		std::sort(sorted.begin(), sorted.end());
 
-					GSvsync(p->param);
-					frame_number++;
+		for (double t : sorted) avg += t;
+		avg /= sorted.size();
 
-					break;
+		min = sorted.front();
+		max = sorted.back();
+		p99 = sorted[std::min(sorted.size() - 1, (size_t)(sorted.size() * 0.99))];
+	}
 
-				case 2:
+	size_t nb = std::max<size_t>(frames.size(), 1);
 
-					if(buff.size() < p->size) buff.resize(p->size);
+	static const char* counter_names[] = {"frame", "prim", "draw", "swizzle", "unswizzle", "fillrate", "quad", "syncpoint", "merged", "fence", "hashhit", "hashsaved", "hashed"};
+	static_assert(countof(counter_names) == GSPerfMon::CounterLast, "GSPerfMon counter names are out of sync");
 
-					GSreadFIFO2(&buff[0], p->size / 16);
+	fprintf(stdout, "GSdx benchmark: %s\n", lpszCmdLine);
+	fprintf(stdout, "renderer %s%s, %d loop(s), %zu frames in %.2f ms (%.2f fps)\n",
+		renderer_name, type == GSRendererType::OGL_SW ? format(" (%d threads)", threads).c_str() : "",
+		loops, frames.size(), total_ms, frames.size() * 1000.0 / std::max(total_ms, 1e-3));
+	fprintf(stdout, "frame time (ms): min %.3f | avg %.3f | p99 %.3f | max %.3f\n", min, avg, p99, max);
 
-					break;
+	for (int c = GSPerfMon::Prim; c < GSPerfMon::CounterLast; c++)
+	{
+		fprintf(stdout, "%10s: %14.0f total | %12.2f per frame\n", counter_names[c],
+			pm.GetAccumulated((GSPerfMon::counter_t)c), pm.GetAccumulated((GSPerfMon::counter_t)c) / nb);
+	}
+
+	fprintf(stdout, "    main: %3d%% CPU\n", (int)(100 * pm.GetAccumulatedTicks(GSPerfMon::Main) / tsc_elapsed));
+	fprintf(stdout, "    sync: %3d%% CPU\n", (int)(100 * pm.GetAccumulatedTicks(GSPerfMon::Sync) / tsc_elapsed));
+	fprintf(stdout, "    hash: %3d%% CPU\n", (int)(100 * pm.GetAccumulatedTicks(GSPerfMon::TexHash) / tsc_elapsed));
 
-				case 3:
+	for (int i = 0; i < threads && i < GSPerfMon::MaxWorkers; i++)
+	{
+		fprintf(stdout, " worker%-2d: %3d%% CPU, %3d%% idle\n", i,
+			(int)(100 * pm.GetAccumulatedTicks(GSPerfMon::WorkerDraw0 + i) / tsc_elapsed),
+			(int)(100 * pm.GetAccumulatedTicks(GSPerfMon::WorkerIdle0 + i) / tsc_elapsed));
+	}
 
-					memcpy(regs, &p->buff[0], 0x2000);
+	if (json_path)
+	{
+		FILE* fp = fopen(json_path, "w");
 
-					break;
+		if (fp)
+		{
+			fprintf(fp, "{\n");
+			fprintf(fp, "\t\"dump\": %s,\n", GSReplayJsonString(lpszCmdLine).c_str());
+			fprintf(fp, "\t\"renderer\": %s,\n", GSReplayJsonString(renderer_name).c_str());
+			fprintf(fp, "\t\"threads\": %d,\n", type == GSRendererType::OGL_SW ? threads : 0);
+			fprintf(fp, "\t\"loops\": %d,\n", loops);
+			fprintf(fp, "\t\"frames\": %zu,\n", frames.size());
+			fprintf(fp, "\t\"total_ms\": %.3f,\n", total_ms);
+			fprintf(fp, "\t\"frame_ms\": {\"min\": %.4f, \"avg\": %.4f, \"p99\": %.4f, \"max\": %.4f},\n", min, avg, p99, max);
+			fprintf(fp, "\t\"counters\": {");
+			for (int c = GSPerfMon::Prim; c < GSPerfMon::CounterLast; c++)
+			{
+				fprintf(fp, "%s\"%s\": %.0f", c == GSPerfMon::Prim ? "" : ", ", counter_names[c], pm.GetAccumulated((GSPerfMon::counter_t)c));
 			}
-		}
+			fprintf(fp, "},\n");
+			fprintf(fp, "\t\"cpu_percent\": {\"main\": %.2f, \"sync\": %.2f, \"hash\": %.2f, \"workers\": [",
+				100.0 * pm.GetAccumulatedTicks(GSPerfMon::Main) / tsc_elapsed,
+				100.0 * pm.GetAccumulatedTicks(GSPerfMon::Sync) / tsc_elapsed,
+				100.0 * pm.GetAccumulatedTicks(GSPerfMon::TexHash) / tsc_elapsed);
+			for (int i = 0; i < threads && i < GSPerfMon::MaxWorkers; i++)
+			{
+				fprintf(fp, "%s%.2f", i ? ", " : "", 100.0 * pm.GetAccumulatedTicks(GSPerfMon::WorkerDraw0 + i) / tsc_elapsed);
+			}
+			fprintf(fp, "], \"workers_idle\": [");
+			for (int i = 0; i < threads && i < GSPerfMon::MaxWorkers; i++)
+			{
+				fprintf(fp, "%s%.2f", i ? ", " : "", 100.0 * pm.GetAccumulatedTicks(GSPerfMon::WorkerIdle0 + i) / tsc_elapsed);
+			}
+			fprintf(fp, "]}\n");
+			fprintf(fp, "}\n");
 
-		if (finished >= 200) {
-			; // Nop for Nvidia Profiler
-		} else if (finished > 90) {
-			sleep(1);
-		} else {
-			finished--;
+			fclose(fp);
+		}
+		else
+		{
+			fprintf(stderr, "GSBenchmarkReplay: failed to open %s\n", json_path);
 		}
 	}
 
-	static_cast<GSDeviceOGL*>(s_gs->m_dev)->GenerateProfilerData();
-
-#ifdef ENABLE_OGL_DEBUG_MEM_BW
-	unsigned long total_frame_nb = std::max(1l, frame_number) << 10;
-	fprintf(stderr, "memory bandwith. T: %f KB/f. V: %f KB/f. U: %f KB/f\n",
-			(float)g_real_texture_upload_byte/(float)total_frame_nb,
-			(float)g_vertex_upload_byte/(float)total_frame_nb,
-			(float)g_uniform_upload_byte/(float)total_frame_nb
-		   );
-#endif
-
-	for(auto i = packets.begin(); i != packets.end(); i++)
+	for (auto i = packets.begin(); i != packets.end(); i++)
 	{
 		delete *i;
 	}
 
 	packets.clear();
 
-	sleep(2);
-
 	GSclose();
 	GSshutdown();
 }
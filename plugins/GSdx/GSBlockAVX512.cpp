@@ -0,0 +1,131 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+// This file is built with -mavx512f -mavx512bw while the rest of the plugin is not. It must not
+// include stdafx.h or the GSVector headers: their inline functions would be compiled for AVX-512
+// here too, and the linker is free to keep these copies for every other file. ENABLE_AVX512 is
+// defined when the compiler takes these flags (see CMakeLists.txt).
+
+#ifdef ENABLE_AVX512
+
+#include <immintrin.h>
+
+typedef unsigned char uint8;
+typedef unsigned short uint16;
+typedef unsigned int uint32;
+
+#include "GSBlockAVX512.h"
+
+#ifdef _MSC_VER
+#define ALIGN64 __declspec(align(64))
+#else
+#define ALIGN64 __attribute__((aligned(64)))
+#endif
+
+// first two rows of columnTable32 and columnTable16, the other columns repeat them
+
+static const ALIGN64 uint32 s_column32[16] = {0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15};
+
+static const ALIGN64 uint16 s_column16[32] =
+{
+	0, 2, 8, 10, 16, 18, 24, 26, 1, 3, 9, 11, 17, 19, 25, 27,
+	4, 6, 12, 14, 20, 22, 28, 30, 5, 7, 13, 15, 21, 23, 29, 31,
+};
+
+static inline void StoreRows(uint8* dst, int dstpitch, __m512i v)
+{
+	_mm256_storeu_si256((__m256i*)&dst[0], _mm512_castsi512_si256(v));
+	_mm256_storeu_si256((__m256i*)&dst[dstpitch], _mm512_extracti64x4_epi64(v, 1));
+}
+
+void GSBlockAVX512::ReadBlock32(const uint8* src, uint8* dst, int dstpitch)
+{
+	__m512i idx = _mm512_load_si512(s_column32);
+
+	for(int i = 0; i < 4; i++, dst += dstpitch * 2)
+	{
+		StoreRows(dst, dstpitch, _mm512_permutexvar_epi32(idx, _mm512_load_si512(&src[i * 64])));
+	}
+}
+
+void GSBlockAVX512::ReadBlock16(const uint8* src, uint8* dst, int dstpitch)
+{
+	__m512i idx = _mm512_load_si512(s_column16);
+
+	for(int i = 0; i < 4; i++, dst += dstpitch * 2)
+	{
+		StoreRows(dst, dstpitch, _mm512_permutexvar_epi16(idx, _mm512_load_si512(&src[i * 64])));
+	}
+}
+
+void GSBlockAVX512::ReadAndExpandBlock24(const uint8* src, uint8* dst, int dstpitch, uint32 TA0, bool AEM)
+{
+	__m512i idx = _mm512_load_si512(s_column32);
+	__m512i mask = _mm512_set1_epi32(0x00ffffff);
+	__m512i ta0 = _mm512_set1_epi32((int)(TA0 << 24));
+
+	for(int i = 0; i < 4; i++, dst += dstpitch * 2)
+	{
+		__m512i c = _mm512_and_si512(_mm512_permutexvar_epi32(idx, _mm512_load_si512(&src[i * 64])), mask);
+
+		// AEM: black (rgb == 0) stays transparent
+
+		__mmask16 k = AEM ? _mm512_test_epi32_mask(c, c) : (__mmask16)0xffff;
+
+		StoreRows(dst, dstpitch, _mm512_mask_or_epi32(c, k, c, ta0));
+	}
+}
+
+void GSBlockAVX512::ReadAndExpandBlock16(const uint8* src, uint8* dst, int dstpitch, uint32 TA0, uint32 TA1, bool AEM)
+{
+	__m512i idx = _mm512_load_si512(s_column16);
+	__m512i rmask = _mm512_set1_epi32(0x001f);
+	__m512i gmask = _mm512_set1_epi32(0x03e0);
+	__m512i bmask = _mm512_set1_epi32(0x7c00);
+	__m512i amask = _mm512_set1_epi32(0x8000);
+	__m512i ta0 = _mm512_set1_epi32((int)(TA0 << 24));
+	__m512i ta1 = _mm512_set1_epi32((int)(TA1 << 24));
+
+	for(int i = 0; i < 4; i++)
+	{
+		__m512i v = _mm512_permutexvar_epi16(idx, _mm512_load_si512(&src[i * 64]));
+
+		for(int j = 0; j < 2; j++, dst += dstpitch)
+		{
+			__m512i c = _mm512_cvtepu16_epi32(j == 0 ? _mm512_castsi512_si256(v) : _mm512_extracti64x4_epi64(v, 1));
+
+			__m512i r = _mm512_slli_epi32(_mm512_and_si512(c, rmask), 3);
+			__m512i g = _mm512_slli_epi32(_mm512_and_si512(c, gmask), 6);
+			__m512i b = _mm512_slli_epi32(_mm512_and_si512(c, bmask), 9);
+
+			__m512i a = _mm512_mask_blend_epi32(_mm512_test_epi32_mask(c, amask), ta0, ta1);
+
+			if(AEM)
+			{
+				a = _mm512_maskz_mov_epi32(_mm512_test_epi32_mask(c, c), a);
+			}
+
+			_mm512_storeu_si512(dst, _mm512_or_si512(_mm512_or_si512(r, g), _mm512_or_si512(b, a)));
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,40 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+// AVX-512 (F + BW) versions of the GSBlock unswizzle kernels. A column of a 32 or 16 bits block
+// is exactly one zmm register, so each one is a single permute instead of the unpack chains of
+// GSBlock. They are not tied to _M_SSE: GSBlockAVX512.cpp is the only file built with the AVX-512
+// flags, and GSLocalMemory selects these at runtime when g_cpu has AVX512F and AVX512BW. All of it
+// is only built when ENABLE_AVX512 is defined, the compiler may not know the flags.
+
+class GSBlockAVX512
+{
+public:
+	static void ReadBlock32(const uint8* src, uint8* dst, int dstpitch);
+	static void ReadBlock16(const uint8* src, uint8* dst, int dstpitch);
+
+	// TA0 and TA1 are the TEXA fields, not shifted
+
+	static void ReadAndExpandBlock24(const uint8* src, uint8* dst, int dstpitch, uint32 TA0, bool AEM);
+	static void ReadAndExpandBlock16(const uint8* src, uint8* dst, int dstpitch, uint32 TA0, uint32 TA1, bool AEM);
+};
@@ -375,6 +375,7 @@ GSCapture::GSCapture()
 	m_threads = theApp.GetConfigI("capture_threads");
 #if defined(__unix__)
 	m_compression_level = theApp.GetConfigI("png_compression_level");
+	m_y4m = NULL;
 #endif
 }
 
@@ -482,8 +483,54 @@ bool GSCapture::BeginCapture(float fps, GSVector2i recommendedResolution, float
 	m_size.x = theApp.GetConfigI("CaptureWidth");
 	m_size.y = theApp.GetConfigI("CaptureHeight");
 
-	for(int i = 0; i < m_threads; i++) {
-		m_workers.push_back(std::unique_ptr<GSPng::Worker>(new GSPng::Worker(&GSPng::Process)));
+	m_format = theApp.GetConfigI("capture_format");
+	m_fps = fps;
+
+	if(m_format == CAPTURE_Y4M)
+	{
+		std::string out_file = m_out_dir + "/capture.y4m";
+
+		m_y4m = fopen(out_file.c_str(), "wb");
+
+		if(m_y4m == NULL)
+		{
+			fprintf(stderr, "GSdx: can't open %s for the capture\n", out_file.c_str());
+
+			return false;
+		}
+
+		// BT.601 limited range, see Encode
+		fprintf(m_y4m, "YUV4MPEG2 W%d H%d F%d:1000 Ip A1:1 C444 XYSCSS=444 XCOLORRANGE=LIMITED\n", m_size.x, m_size.y, (int)(fps * 1000 + 0.5f));
+	}
+
+	int threads = std::max<int>(m_threads, 1);
+
+	// Two frames per encoder: one being encoded and one waiting, anything more only adds latency
+
+	for(int i = 0; i < threads * 2; i++)
+	{
+		Frame* f = new Frame();
+
+		f->buff.resize(m_size.x * m_size.y * 4);
+
+		if(m_format == CAPTURE_Y4M)
+		{
+			f->yuv.resize(m_size.x * m_size.y * 3);
+		}
+
+		m_frames.push_back(std::unique_ptr<Frame>(f));
+		m_free.push_back(f);
+	}
+
+	m_queued = 0;
+	m_written = 0;
+	m_exit = false;
+
+	memset(&m_stats, 0, sizeof(m_stats));
+
+	for(int i = 0; i < threads; i++)
+	{
+		m_workers.push_back(std::thread(&GSCapture::WorkerThread, this));
 	}
 #endif
 
@@ -514,11 +561,56 @@ bool GSCapture::DeliverFrame(const void* bits, int pitch, bool rgba)
 
 #elif defined(__unix__)
 
-	std::string out_file = m_out_dir + format("/frame.%010d.png", m_frame);
-	//GSPng::Save(GSPng::RGB_PNG, out_file, (uint8*)bits, m_size.x, m_size.y, pitch, m_compression_level);
-	m_workers[m_frame%m_threads]->Push(std::make_shared<GSPng::Transaction>(GSPng::RGB_PNG, out_file, static_cast<const uint8*>(bits), m_size.x, m_size.y, pitch, m_compression_level));
+	auto start = std::chrono::steady_clock::now();
 
-	m_frame++;
+	Frame* f = NULL;
+
+	{
+		std::lock_guard<std::mutex> l(m_queue_lock);
+
+		if(!m_free.empty())
+		{
+			f = m_free.back();
+
+			m_free.pop_back();
+		}
+		else
+		{
+			m_stats.dropped++;
+		}
+	}
+
+	// PNG frames keep their number so that dropped frames show up as holes in the sequence
+
+	uint64 frame = m_frame++;
+
+	if(f == NULL)
+	{
+		return false;
+	}
+
+	int line = m_size.x * 4;
+
+	for(int y = 0; y < m_size.y; y++)
+	{
+		memcpy(&f->buff[y * line], (const uint8*)bits + y * pitch, line);
+	}
+
+	f->index = m_format == CAPTURE_Y4M ? m_queued++ : frame;
+	f->rgba = rgba;
+	f->delivered = start;
+
+	{
+		std::lock_guard<std::mutex> l(m_queue_lock);
+
+		m_queue.push_back(f);
+
+		m_stats.copy += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	m_queue_cv.notify_one();
+
+	return true;
 
 #endif
 
@@ -546,7 +638,40 @@ bool GSCapture::EndCapture()
 	}
 
 #elif defined(__unix__)
-	m_workers.clear();
+
+	if(!m_workers.empty())
+	{
+		{
+			std::lock_guard<std::mutex> l(m_queue_lock);
+
+			m_exit = true;
+		}
+
+		m_queue_cv.notify_all();
+
+		// the queue is drained before the threads exit
+
+		for(auto& t : m_workers)
+		{
+			t.join();
+		}
+
+		m_workers.clear();
+
+		PrintStats();
+	}
+
+	if(m_y4m != NULL)
+	{
+		fclose(m_y4m);
+
+		m_y4m = NULL;
+	}
+
+	m_encoded.clear();
+	m_queue.clear();
+	m_free.clear();
+	m_frames.clear();
 
 	m_frame = 0;
 
@@ -556,3 +681,150 @@ bool GSCapture::EndCapture()
 
 	return true;
 }
+
+#ifdef __unix__
+
+void GSCapture::WorkerThread()
+{
+	while(true)
+	{
+		Frame* f;
+
+		{
+			std::unique_lock<std::mutex> l(m_queue_lock);
+
+			m_queue_cv.wait(l, [this] {return !m_queue.empty() || m_exit;});
+
+			if(m_queue.empty())
+			{
+				break;
+			}
+
+			f = m_queue.front();
+
+			m_queue.pop_front();
+		}
+
+		auto start = std::chrono::steady_clock::now();
+
+		Encode(f);
+
+		double encode = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		{
+			std::lock_guard<std::mutex> l(m_queue_lock);
+
+			m_stats.encode += encode;
+		}
+
+		Write(f);
+	}
+}
+
+void GSCapture::Encode(Frame* f)
+{
+	if(m_format == CAPTURE_Y4M)
+	{
+		// BT.601, limited range
+
+		int size = m_size.x * m_size.y;
+
+		uint8* RESTRICT py = &f->yuv[0];
+		uint8* RESTRICT pu = py + size;
+		uint8* RESTRICT pv = pu + size;
+
+		const uint8* src = &f->buff[0];
+
+		int ri = f->rgba ? 0 : 2;
+		int bi = f->rgba ? 2 : 0;
+
+		for(int i = 0; i < size; i++, src += 4)
+		{
+			int r = src[ri];
+			int g = src[1];
+			int b = src[bi];
+
+			py[i] = (uint8)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+			pu[i] = (uint8)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+			pv[i] = (uint8)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+		}
+	}
+	else
+	{
+		std::string out_file = m_out_dir + format("/frame.%010llu.png", f->index);
+
+		GSPng::Save(GSPng::RGB_PNG, out_file, &f->buff[0], m_size.x, m_size.y, m_size.x * 4, m_compression_level, !f->rgba);
+	}
+}
+
+void GSCapture::Write(Frame* f)
+{
+	if(m_format != CAPTURE_Y4M)
+	{
+		Release(f);
+
+		return;
+	}
+
+	// Frames of a Y4M stream must be written in order. Whoever encodes the next frame to be
+	// written also writes the ones which were encoded before it by the other threads.
+
+	std::unique_lock<std::mutex> l(m_queue_lock);
+
+	m_encoded[f->index] = f;
+
+	while(true)
+	{
+		auto i = m_encoded.find(m_written);
+
+		if(i == m_encoded.end())
+		{
+			break;
+		}
+
+		f = i->second;
+
+		m_encoded.erase(i);
+
+		// only the thread which took m_written writes, the others can keep queueing frames meanwhile
+
+		l.unlock();
+
+		fwrite("FRAME\n", 6, 1, m_y4m);
+		fwrite(&f->yuv[0], f->yuv.size(), 1, m_y4m);
+
+		Release(f);
+
+		l.lock();
+
+		m_written++;
+	}
+}
+
+void GSCapture::Release(Frame* f)
+{
+	double latency = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - f->delivered).count();
+
+	std::lock_guard<std::mutex> l(m_queue_lock);
+
+	m_stats.latency += latency;
+	m_stats.latency_max = std::max(m_stats.latency_max, latency);
+
+	m_free.push_back(f);
+}
+
+void GSCapture::PrintStats()
+{
+	uint64 written = m_frame - m_stats.dropped;
+
+	if(written == 0)
+	{
+		return;
+	}
+
+	printf("GSdx capture: %llu frames written, %llu dropped (%.1f%%), copy %.2f ms, encode %.2f ms, latency %.2f ms (max %.2f ms)\n",
+		written, m_stats.dropped, 100.0 * m_stats.dropped / m_frame,
+		m_stats.copy / written, m_stats.encode / written, m_stats.latency / written, m_stats.latency_max);
+}
+
+#endif
@@ -24,6 +24,10 @@
 #include "GSVector.h"
 #include "GSPng.h"
 
+#ifdef __unix__
+#include <chrono>
+#endif
+
 #ifdef _WIN32
 #include "GSCaptureDlg.h"
 #endif
@@ -44,8 +48,52 @@ class GSCapture
 
 	#elif defined(__unix__)
 
-	std::vector<std::unique_ptr<GSPng::Worker>> m_workers;
+	// Frames are copied once into a buffer of a fixed pool and queued for the encoder threads,
+	// which give the buffer back when the frame is written. If the encoders can't keep up and
+	// the pool is empty, the frame is dropped (and counted) instead of stalling the GS thread.
+
+	enum {CAPTURE_PNG, CAPTURE_Y4M};
+
+	struct Frame
+	{
+		std::vector<uint8> buff; // RGBA, m_size.x * 4 bytes per line
+		std::vector<uint8> yuv; // Y4M only, planar 4:4:4
+		uint64 index; // PNG: frame number, Y4M: position in the stream
+		bool rgba;
+		std::chrono::steady_clock::time_point delivered;
+	};
+
+	int m_format;
 	int m_compression_level;
+	float m_fps;
+	FILE* m_y4m;
+
+	std::vector<std::unique_ptr<Frame>> m_frames;
+	std::vector<Frame*> m_free;
+	std::deque<Frame*> m_queue;
+	std::map<uint64, Frame*> m_encoded; // Y4M frames waiting for the previous ones to be written
+	uint64 m_queued;
+	uint64 m_written;
+	bool m_exit;
+
+	std::vector<std::thread> m_workers;
+	std::mutex m_queue_lock;
+	std::condition_variable m_queue_cv;
+
+	struct
+	{
+		uint64 dropped;
+		double copy; // ms, on the GS thread
+		double encode; // ms, summed over the encoder threads
+		double latency; // ms, from DeliverFrame to the frame being written
+		double latency_max;
+	} m_stats;
+
+	void WorkerThread();
+	void Encode(Frame* f);
+	void Write(Frame* f);
+	void Release(Frame* f);
+	void PrintStats();
 
 	#endif
 
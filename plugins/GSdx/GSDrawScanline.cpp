@@ -21,6 +21,7 @@
 
 #include "stdafx.h"
 #include "GSDrawScanline.h"
+#include "GSdx.h"
 #include "GSTextureCacheSW.h"
 
 // Lack of a better home
@@ -33,6 +34,19 @@ GSDrawScanline::GSDrawScanline()
 	memset(&m_local, 0, sizeof(m_local));
 
 	m_local.gd = &m_global;
+
+	g_scanline_key_cache.Attach(this);
+}
+
+GSDrawScanline::~GSDrawScanline()
+{
+	g_scanline_key_cache.Detach(this);
+}
+
+void GSDrawScanline::GetPrebuildStats(size_t& prebuilt, size_t& prebuilt_used, size_t& ondemand)
+{
+	m_ds_map.GetPrebuildStats(prebuilt, prebuilt_used, ondemand);
+	m_sp_map.GetPrebuildStats(prebuilt, prebuilt_used, ondemand);
 }
 
 void GSDrawScanline::BeginDraw(const GSRasterizerData* data)
@@ -114,6 +128,223 @@ void GSDrawScanline::EndDraw(uint64 frame, uint64 ticks, int actual, int total)
 	m_ds_map.UpdateStats(frame, ticks, actual, total);
 }
 
+// GSScanlineKeyCache
+
+GSScanlineKeyCache g_scanline_key_cache;
+
+#define SCANLINE_KEY_CACHE_MAGIC 0x434a5347 // "GSJC"
+#define SCANLINE_KEY_CACHE_VERSION 1 // bump when GSScanlineSelector or the code generators change
+#define SCANLINE_KEY_CACHE_MAX_KEYS 4096
+
+GSScanlineKeyCache::GSScanlineKeyCache()
+	: m_crc(0)
+	, m_enabled(false)
+	, m_exit(false)
+	, m_warmup_ms(0)
+{
+}
+
+GSScanlineKeyCache::~GSScanlineKeyCache()
+{
+	Stop();
+}
+
+void GSScanlineKeyCache::Attach(GSDrawScanline* ds)
+{
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	m_instances.push_back(ds);
+}
+
+void GSScanlineKeyCache::Detach(GSDrawScanline* ds)
+{
+	// waits for the warmup thread to be done with ds
+
+	std::lock_guard<std::mutex> lock(m_lock);
+
+	m_instances.erase(std::remove(m_instances.begin(), m_instances.end(), ds), m_instances.end());
+}
+
+std::string GSScanlineKeyCache::GetFileName(uint32 crc) const
+{
+	return theApp.GetConfigDir() + format("GSdx_jit_%08X.bin", crc);
+}
+
+void GSScanlineKeyCache::Load()
+{
+	m_ds_keys.clear();
+	m_sp_keys.clear();
+
+	FILE* fp = fopen(GetFileName(m_crc).c_str(), "rb");
+
+	if(fp == NULL)
+	{
+		return;
+	}
+
+	uint32 header[5];
+
+	if(fread(header, sizeof(header), 1, fp) == 1
+	&& header[0] == SCANLINE_KEY_CACHE_MAGIC && header[1] == SCANLINE_KEY_CACHE_VERSION && header[2] == m_crc
+	&& header[3] <= SCANLINE_KEY_CACHE_MAX_KEYS && header[4] <= SCANLINE_KEY_CACHE_MAX_KEYS)
+	{
+		m_ds_keys.resize(header[3]);
+		m_sp_keys.resize(header[4]);
+
+		if((!m_ds_keys.empty() && fread(m_ds_keys.data(), sizeof(uint64), m_ds_keys.size(), fp) != m_ds_keys.size())
+		|| (!m_sp_keys.empty() && fread(m_sp_keys.data(), sizeof(uint64), m_sp_keys.size(), fp) != m_sp_keys.size()))
+		{
+			m_ds_keys.clear();
+			m_sp_keys.clear();
+		}
+	}
+
+	fclose(fp);
+}
+
+size_t GSScanlineKeyCache::Save()
+{
+	// keys used during this session, plus the ones of the previous sessions
+
+	std::set<uint64> ds(m_ds_keys.begin(), m_ds_keys.end());
+	std::set<uint64> sp(m_sp_keys.begin(), m_sp_keys.end());
+
+	size_t loaded = ds.size() + sp.size();
+
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		for(auto i : m_instances)
+		{
+			i->GetUsedKeys(ds, sp);
+		}
+	}
+
+	size_t added = ds.size() + sp.size() - loaded;
+
+	if(added == 0)
+	{
+		return 0; // the file already has all of them
+	}
+
+	std::vector<uint64> ds_keys(ds.begin(), ds.end());
+	std::vector<uint64> sp_keys(sp.begin(), sp.end());
+
+	ds_keys.resize(std::min<size_t>(ds_keys.size(), SCANLINE_KEY_CACHE_MAX_KEYS));
+	sp_keys.resize(std::min<size_t>(sp_keys.size(), SCANLINE_KEY_CACHE_MAX_KEYS));
+
+	FILE* fp = fopen(GetFileName(m_crc).c_str(), "wb");
+
+	if(fp == NULL)
+	{
+		fprintf(stderr, "GSdx: failed to save the JIT key cache of game %08X\n", m_crc);
+
+		return 0;
+	}
+
+	uint32 header[5] = {SCANLINE_KEY_CACHE_MAGIC, SCANLINE_KEY_CACHE_VERSION, m_crc, (uint32)ds_keys.size(), (uint32)sp_keys.size()};
+
+	fwrite(header, sizeof(header), 1, fp);
+	fwrite(ds_keys.data(), sizeof(uint64), ds_keys.size(), fp);
+	fwrite(sp_keys.data(), sizeof(uint64), sp_keys.size(), fp);
+
+	fclose(fp);
+
+	return added;
+}
+
+void GSScanlineKeyCache::Warmup()
+{
+	auto start = std::chrono::steady_clock::now();
+
+	// The lock is taken per key so that draws on the rasterizer threads, which only need it
+	// for the keys they don't know yet, never wait long.
+
+	for(size_t i = 0; i < m_ds_keys.size() + m_sp_keys.size() && !m_exit; i++)
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		for(auto ds : m_instances)
+		{
+			if(i < m_ds_keys.size())
+			{
+				ds->PrebuildDrawScanline(m_ds_keys[i]);
+			}
+			else
+			{
+				ds->PrebuildSetupPrim(m_sp_keys[i - m_ds_keys.size()]);
+			}
+		}
+	}
+
+	m_warmup_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void GSScanlineKeyCache::Stop()
+{
+	if(m_thread.joinable())
+	{
+		m_exit = true;
+		m_thread.join();
+		m_exit = false;
+	}
+}
+
+void GSScanlineKeyCache::Open(uint32 crc, bool enabled)
+{
+	if(crc == m_crc && enabled == m_enabled)
+	{
+		return;
+	}
+
+	Close();
+
+	m_crc = crc;
+	m_enabled = enabled;
+
+	if(!m_enabled || m_crc == 0)
+	{
+		return;
+	}
+
+	Load();
+
+	if(!m_ds_keys.empty() || !m_sp_keys.empty())
+	{
+		m_warmup_ms = 0;
+		m_thread = std::thread(&GSScanlineKeyCache::Warmup, this);
+	}
+}
+
+void GSScanlineKeyCache::Close()
+{
+	Stop();
+
+	// The stats are only printed when the session added keys, not on every close of a game
+	// which is already cached
+
+	if(m_enabled && m_crc != 0 && Save() > 0)
+	{
+		size_t prebuilt = 0, prebuilt_used = 0, ondemand = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(m_lock);
+
+			for(auto i : m_instances)
+			{
+				i->GetPrebuildStats(prebuilt, prebuilt_used, ondemand);
+			}
+		}
+
+		fprintf(stderr, "GSdx: JIT key cache %08X: %zu/%zu keys loaded, %zu functions prebuilt in %llu ms (%zu used), %zu generated on demand\n",
+			m_crc, m_ds_keys.size(), m_sp_keys.size(), prebuilt, m_warmup_ms, prebuilt_used, ondemand);
+	}
+
+	m_ds_keys.clear();
+	m_sp_keys.clear();
+	m_crc = 0;
+}
+
 #ifndef ENABLE_JIT_RASTERIZER
 
 void GSDrawScanline::SetupPrim(const GSVertexSW* vertex, const uint32* index, const GSVertexSW& dscan)
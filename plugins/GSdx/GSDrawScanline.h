@@ -63,7 +63,7 @@ protected:
 
 public:
 	GSDrawScanline();
-	virtual ~GSDrawScanline() = default;
+	virtual ~GSDrawScanline();
 
 	// IDrawScanline
 
@@ -87,4 +87,52 @@ public:
 #endif
 
 	void PrintStats() {m_ds_map.PrintStats();}
+
+	// GSScanlineKeyCache
+
+	bool PrebuildDrawScanline(uint64 key) {return m_ds_map.Prebuild(key);}
+	bool PrebuildSetupPrim(uint64 key) {return m_sp_map.Prebuild(key);}
+
+	void GetUsedKeys(std::set<uint64>& ds, std::set<uint64>& sp) {m_ds_map.GetUsedKeys(ds); m_sp_map.GetUsedKeys(sp);}
+	void GetPrebuildStats(size_t& prebuilt, size_t& prebuilt_used, size_t& ondemand);
+};
+
+// Remembers the draw scanline and setup prim selectors each game used, in a small file per
+// game CRC next to GSdx.ini. When the game starts again, the functions of those selectors
+// are generated by a background thread for every GSDrawScanline, instead of in the middle
+// of the draw which first needs them.
+//
+// Only the keys are saved, the generated code embeds the address of its GSDrawScanline's
+// local data and can't be reused by another instance or session.
+
+class GSScanlineKeyCache
+{
+	std::mutex m_lock; // m_instances
+	std::vector<GSDrawScanline*> m_instances;
+	std::vector<uint64> m_ds_keys; // keys loaded for m_crc
+	std::vector<uint64> m_sp_keys;
+	uint32 m_crc;
+	bool m_enabled;
+	std::thread m_thread;
+	std::atomic<bool> m_exit;
+	uint64 m_warmup_ms;
+
+	std::string GetFileName(uint32 crc) const;
+	void Load();
+	size_t Save(); // returns the number of keys this session added
+	void Warmup();
+	void Stop();
+
+public:
+	GSScanlineKeyCache();
+	virtual ~GSScanlineKeyCache();
+
+	void Attach(GSDrawScanline* ds);
+	void Detach(GSDrawScanline* ds);
+
+	// GS thread only
+	void Open(uint32 crc, bool enabled);
+	void Close();
 };
+
+extern GSScanlineKeyCache g_scanline_key_cache;
@@ -25,6 +25,7 @@
 GSDumpBase::GSDumpBase(const std::string& fn)
 	: m_frames(0)
 	, m_extra_frames(2)
+	, m_failed(false)
 {
 	m_gs = fopen(fn.c_str(), "wb");
 	if (!m_gs)
@@ -68,7 +69,7 @@ void GSDumpBase::ReadFIFO(uint32 size)
 bool GSDumpBase::VSync(int field, bool last, const GSPrivRegSet* regs)
 {
 	// dump file is bad, return done to delete the object
-	if (!m_gs)
+	if (!m_gs || m_failed)
 		return true;
 
 	AppendRawData(3);
@@ -192,3 +193,127 @@ void GSDumpXz::Compress(lzma_action action, lzma_ret expected_status)
 
 	} while (m_strm.avail_out == 0);
 }
+
+//////////////////////////////////////////////////////////////////////
+// GSDumpKeyframed implementation
+//////////////////////////////////////////////////////////////////////
+
+GSDumpKeyframed::GSDumpKeyframed(const std::string& fn, uint32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs, int interval)
+	: GSDumpBase(fn + ".gsk")
+	, m_interval(std::max(interval, 1))
+	, m_offset(0)
+	, m_compressor([this](std::shared_ptr<Block>& block) {Compress(block);})
+{
+	uint32 header[4] = {GSDUMP_KEYFRAMED_MAGIC, GSDUMP_KEYFRAMED_VERSION, crc, (uint32)m_interval};
+
+	Write(header, sizeof(header));
+
+	m_offset = sizeof(header);
+
+	BeginBlock(fd, regs);
+}
+
+GSDumpKeyframed::~GSDumpKeyframed()
+{
+	EndBlock();
+
+	m_compressor.Wait();
+
+	// Without the index and the trailer the replayer rejects the file, a partial index would not
+	// describe the stream
+	if (m_failed) {
+		fprintf(stderr, "GSDumpKeyframed: The dump is incomplete and can't be replayed\n");
+		return;
+	}
+
+	uint32 count = (uint32)m_index.size();
+	uint32 magic = GSDUMP_KEYFRAMED_INDEX_MAGIC;
+
+	Write(m_index.data(), m_index.size() * sizeof(GSDumpBlockIndex));
+	Write(&m_offset, 8);
+	Write(&count, 4);
+	Write(&magic, 4);
+}
+
+void GSDumpKeyframed::BeginBlock(const GSFreezeData& fd, const GSPrivRegSet* regs)
+{
+	m_block = std::make_shared<Block>();
+
+	m_block->frame = GetFrameCount();
+	m_block->frames = 0;
+
+	AppendRawData(&fd.size, 4);
+	AppendRawData(fd.data, fd.size);
+	AppendRawData(regs, sizeof(*regs));
+}
+
+void GSDumpKeyframed::EndBlock()
+{
+	if(!m_block)
+		return;
+
+	m_block->frames = GetFrameCount() - m_block->frame;
+
+	m_compressor.Push(m_block);
+
+	m_block.reset();
+}
+
+bool GSDumpKeyframed::IsKeyframeDue()
+{
+	return GetFrameCount() - (int)m_block->frame >= m_interval;
+}
+
+void GSDumpKeyframed::Keyframe(const GSFreezeData& fd, const GSPrivRegSet* regs)
+{
+	EndBlock();
+	BeginBlock(fd, regs);
+}
+
+void GSDumpKeyframed::Compress(std::shared_ptr<Block>& block)
+{
+	// Blocks after a failed one are of no use, their keyframes can't be reached from the index
+	if (m_failed) {
+		block.reset();
+		return;
+	}
+
+	std::vector<uint8> out(lzma_stream_buffer_bound(block->data.size()));
+	size_t out_size = 0;
+
+	lzma_ret ret = lzma_easy_buffer_encode(6 /*level*/, LZMA_CHECK_CRC64, NULL, block->data.data(), block->data.size(), out.data(), &out_size, out.size());
+
+	if (ret != LZMA_OK) {
+		fprintf(stderr, "GSDumpKeyframed: Error compressing the block of frame %u (error code %u)\n", block->frame, ret);
+		m_failed = true;
+		block.reset();
+		return;
+	}
+
+	GSDumpBlockIndex index;
+
+	index.offset = m_offset;
+	index.compressed_size = (uint32)out_size;
+	index.size = (uint32)block->data.size();
+	index.frame = block->frame;
+	index.frames = block->frames;
+
+	Write(out.data(), out_size);
+
+	m_index.push_back(index);
+	m_offset += out_size;
+
+	block.reset();
+}
+
+void GSDumpKeyframed::AppendRawData(const void *data, size_t size)
+{
+	const uint8* src = static_cast<const uint8*>(data);
+
+	m_block->data.insert(m_block->data.end(), src, src + size);
+}
+
+void GSDumpKeyframed::AppendRawData(uint8 c)
+{
+	m_block->data.push_back(c);
+}
@@ -23,6 +23,7 @@
 
 #include "GS.h"
 #include "GSVertexSW.h"
+#include "GSThread_CXX11.h"
 #include <lzma.h>
 
 /*
@@ -42,8 +43,34 @@ ReadFIFO2 data (id == 2)
 Regs data (id == 3)
 - [PMODE/0x2000]
 
+Keyframed dump file format (.gsk):
+- [magic/4] [version/4] [crc/4] [keyframe interval/4] [block/?] .. [block/?] [index/?] [trailer/16]
+
+Each block is an independent xz stream. Decompressed, it starts with a keyframe: the GS
+state at the beginning of the block, followed by the packets above.
+- [state size/4] [state data/size] [PMODE/0x2000] [id/1] [data/?] .. [id/1] [data/?]
+
+Index
+- [GSDumpBlockIndex/24] .. [GSDumpBlockIndex/24] (one per block)
+
+Trailer
+- [index offset/8] [block count/4] [magic/4]
+
 */
 
+#define GSDUMP_KEYFRAMED_MAGIC 0x314b5347 // "GSK1"
+#define GSDUMP_KEYFRAMED_INDEX_MAGIC 0x58444e49 // "INDX"
+#define GSDUMP_KEYFRAMED_VERSION 1
+
+struct GSDumpBlockIndex
+{
+	uint64 offset; // in the file
+	uint32 compressed_size;
+	uint32 size;
+	uint32 frame; // first frame of the block, the keyframe
+	uint32 frames;
+};
+
 class GSDumpBase
 {
 	int m_frames;
@@ -51,9 +78,14 @@ class GSDumpBase
 	FILE* m_gs;
 
 protected:
+	// Set when the file can't be completed, the dump then stops at the next vsync
+	std::atomic<bool> m_failed;
+
 	void AddHeader(uint32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs);
 	void Write(const void *data, size_t size);
 
+	int GetFrameCount() const {return m_frames;}
+
 	virtual void AppendRawData(const void *data, size_t size) = 0;
 	virtual void AppendRawData(uint8 c) = 0;
 
@@ -64,6 +96,10 @@ public:
 	void ReadFIFO(uint32 size);
 	void Transfer(int index, const uint8* mem, size_t size);
 	bool VSync(int field, bool last, const GSPrivRegSet* regs);
+
+	// The renderer freezes its state into a new keyframe after the vsync when one is due
+	virtual bool IsKeyframeDue() {return false;}
+	virtual void Keyframe(const GSFreezeData& fd, const GSPrivRegSet* regs) {}
 };
 
 class GSDump final : public GSDumpBase
@@ -91,3 +127,34 @@ public:
 	GSDumpXz(const std::string& fn, uint32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs);
 	virtual ~GSDumpXz();
 };
+
+class GSDumpKeyframed final : public GSDumpBase
+{
+	struct Block
+	{
+		std::vector<uint8> data;
+		uint32 frame;
+		uint32 frames;
+	};
+
+	int m_interval;
+	std::shared_ptr<Block> m_block;
+	std::vector<GSDumpBlockIndex> m_index;
+	uint64 m_offset;
+
+	// Blocks are compressed and written on another thread, in order
+	GSJobQueue<std::shared_ptr<Block>, 16> m_compressor;
+
+	void BeginBlock(const GSFreezeData& fd, const GSPrivRegSet* regs);
+	void EndBlock();
+	void Compress(std::shared_ptr<Block>& block);
+	void AppendRawData(const void *data, size_t size) final;
+	void AppendRawData(uint8 c) final;
+
+public:
+	GSDumpKeyframed(const std::string& fn, uint32 crc, const GSFreezeData& fd, const GSPrivRegSet* regs, int interval);
+	virtual ~GSDumpKeyframed();
+
+	bool IsKeyframeDue() final;
+	void Keyframe(const GSFreezeData& fd, const GSPrivRegSet* regs) final;
+};
@@ -163,13 +163,89 @@ class GSCodeGeneratorFunctionMap : public GSFunctionMap<KEY, VALUE>
 	GSCodeBuffer m_cb;
 	size_t m_total_code_size;
 
+	// m_cgmap and m_cb can also be filled by Prebuild from another thread
+	std::mutex m_lock;
+	std::set<uint64> m_prebuilt; // prebuilt keys which haven't been used yet
+	size_t m_prebuilt_count;
+	size_t m_prebuilt_used;
+	size_t m_ondemand_count;
+
 	enum {MAX_SIZE = 8192};
 
+	VALUE Generate(uint64 key)
+	{
+		void* code_ptr = m_cb.GetBuffer(MAX_SIZE);
+
+		CG* cg = new CG(m_param, key, code_ptr, MAX_SIZE);
+		ASSERT(cg->getSize() < MAX_SIZE);
+
+#if 0
+		fprintf(stderr, "%s Location:%p Size:%zu Key:%llx\n", m_name.c_str(), code_ptr, cg->getSize(), (uint64)key);
+		GSScanlineSelector sel(key);
+		sel.Print();
+#endif
+
+		m_total_code_size += cg->getSize();
+
+		m_cb.ReleaseBuffer(cg->getSize());
+
+		VALUE ret = (VALUE)cg->getCode();
+
+		m_cgmap[key] = ret;
+
+		#ifdef ENABLE_VTUNE
+
+		// vtune method registration
+
+		// if(iJIT_IsProfilingActive()) // always > 0
+		{
+			std::string name = format("%s<%016llx>()", m_name.c_str(), (uint64)key);
+
+			iJIT_Method_Load ml;
+
+			memset(&ml, 0, sizeof(ml));
+
+			ml.method_id = iJIT_GetNewMethodID();
+			ml.method_name = (char*)name.c_str();
+			ml.method_load_address = (void*)cg->getCode();
+			ml.method_size = (unsigned int)cg->getSize();
+
+			iJIT_NotifyEvent(iJVM_EVENT_TYPE_METHOD_LOAD_FINISHED, &ml);
+/*
+			name = format("c:/temp1/%s_%016llx.bin", m_name.c_str(), (uint64)key);
+
+			if(FILE* fp = fopen(name.c_str(), "wb"))
+			{
+				fputc(0x0F, fp); fputc(0x0B, fp);
+				fputc(0xBB, fp); fputc(0x6F, fp); fputc(0x00, fp); fputc(0x00, fp); fputc(0x00, fp);
+				fputc(0x64, fp); fputc(0x67, fp); fputc(0x90, fp);
+
+				fwrite(cg->getCode(), cg->getSize(), 1, fp);
+
+				fputc(0xBB, fp); fputc(0xDE, fp); fputc(0x00, fp); fputc(0x00, fp); fputc(0x00, fp);
+				fputc(0x64, fp); fputc(0x67, fp); fputc(0x90, fp);
+				fputc(0x0F, fp); fputc(0x0B, fp);
+
+				fclose(fp);
+			}
+*/
+		}
+
+		#endif
+
+		delete cg;
+
+		return ret;
+	}
+
 public:
 	GSCodeGeneratorFunctionMap(const char* name, void* param)
 		: m_name(name)
 		, m_param(param)
 		, m_total_code_size(0)
+		, m_prebuilt_count(0)
+		, m_prebuilt_used(0)
+		, m_ondemand_count(0)
 	{
 	}
 
@@ -182,78 +258,60 @@ public:
 
 	VALUE GetDefaultFunction(KEY key)
 	{
-		VALUE ret = NULL;
+		std::lock_guard<std::mutex> lock(m_lock);
 
 		auto i = m_cgmap.find(key);
 
 		if(i != m_cgmap.end())
 		{
-			ret = i->second;
+			m_prebuilt_used += m_prebuilt.erase(key);
+
+			return i->second;
 		}
-		else
-		{
-			void* code_ptr = m_cb.GetBuffer(MAX_SIZE);
 
-			CG* cg = new CG(m_param, key, code_ptr, MAX_SIZE);
-			ASSERT(cg->getSize() < MAX_SIZE);
+		m_ondemand_count++;
 
-#if 0
-			fprintf(stderr, "%s Location:%p Size:%zu Key:%llx\n", m_name.c_str(), code_ptr, cg->getSize(), (uint64)key);
-			GSScanlineSelector sel(key);
-			sel.Print();
-#endif
+		return Generate(key);
+	}
 
-			m_total_code_size += cg->getSize();
+	// Generates the function of a key before it's needed. Can be called from any thread.
+	bool Prebuild(KEY key)
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
 
-			m_cb.ReleaseBuffer(cg->getSize());
+		if(m_cgmap.find(key) != m_cgmap.end())
+		{
+			return false;
+		}
 
-			ret = (VALUE)cg->getCode();
+		Generate(key);
 
-			m_cgmap[key] = ret;
+		m_prebuilt.insert(key);
+		m_prebuilt_count++;
 
-			#ifdef ENABLE_VTUNE
+		return true;
+	}
 
-			// vtune method registration
+	// Keys which were actually used to draw (prebuilt and never used ones aren't included)
+	void GetUsedKeys(std::set<uint64>& keys)
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
 
-			// if(iJIT_IsProfilingActive()) // always > 0
+		for(const auto& i : m_cgmap)
+		{
+			if(m_prebuilt.find(i.first) == m_prebuilt.end())
 			{
-				std::string name = format("%s<%016llx>()", m_name.c_str(), (uint64)key);
-
-				iJIT_Method_Load ml;
-
-				memset(&ml, 0, sizeof(ml));
-
-				ml.method_id = iJIT_GetNewMethodID();
-				ml.method_name = (char*)name.c_str();
-				ml.method_load_address = (void*)cg->getCode();
-				ml.method_size = (unsigned int)cg->getSize();
-
-				iJIT_NotifyEvent(iJVM_EVENT_TYPE_METHOD_LOAD_FINISHED, &ml);
-/*
-				name = format("c:/temp1/%s_%016llx.bin", m_name.c_str(), (uint64)key);
-
-				if(FILE* fp = fopen(name.c_str(), "wb"))
-				{
-					fputc(0x0F, fp); fputc(0x0B, fp);
-					fputc(0xBB, fp); fputc(0x6F, fp); fputc(0x00, fp); fputc(0x00, fp); fputc(0x00, fp);
-					fputc(0x64, fp); fputc(0x67, fp); fputc(0x90, fp);
-
-					fwrite(cg->getCode(), cg->getSize(), 1, fp);
-
-					fputc(0xBB, fp); fputc(0xDE, fp); fputc(0x00, fp); fputc(0x00, fp); fputc(0x00, fp);
-					fputc(0x64, fp); fputc(0x67, fp); fputc(0x90, fp);
-					fputc(0x0F, fp); fputc(0x0B, fp);
-
-					fclose(fp);
-				}
-*/
+				keys.insert(i.first);
 			}
-
-			#endif
-
-			delete cg;
 		}
+	}
 
-		return ret;
+	void GetPrebuildStats(size_t& prebuilt, size_t& prebuilt_used, size_t& ondemand)
+	{
+		std::lock_guard<std::mutex> lock(m_lock);
+
+		prebuilt += m_prebuilt_count;
+		prebuilt_used += m_prebuilt_used;
+		ondemand += m_ondemand_count;
 	}
 };
@@ -498,6 +498,8 @@ void populate_record_table(GtkWidget* record_table)
 	GtkWidget* resy_spin     = CreateSpinButton(256, 8192, "CaptureHeight");
 	GtkWidget* threads_label = left_label("Saving Threads:");
 	GtkWidget* threads_spin  = CreateSpinButton(1, 32, "capture_threads");
+	GtkWidget* format_label  = left_label("Format:");
+	GtkWidget* format_combo  = CreateComboBoxFromVector(theApp.m_gs_capture_format, "capture_format");
 	GtkWidget* out_dir_label = left_label("Output Directory:");
 	GtkWidget* out_dir       = CreateFileChooser(GTK_FILE_CHOOSER_ACTION_SELECT_FOLDER, "Select a directory", "capture_out_dir");
 	GtkWidget* png_label     = left_label("PNG Compression Level:");
@@ -505,6 +507,7 @@ void populate_record_table(GtkWidget* record_table)
 
 	InsertWidgetInTable(record_table , capture_check);
 	InsertWidgetInTable(record_table , resxy_label   , resx_spin      , resy_spin);
+	InsertWidgetInTable(record_table , format_label  , format_combo);
 	InsertWidgetInTable(record_table , threads_label , threads_spin);
 	InsertWidgetInTable(record_table , png_label     , png_level);
 	InsertWidgetInTable(record_table , out_dir_label , out_dir);
@@ -27,6 +27,10 @@
 #include "stdafx.h"
 #include "GSLocalMemory.h"
 #include "GSdx.h"
+#ifdef ENABLE_AVX512
+#include "GSUtil.h"
+#include "GSBlockAVX512.h"
+#endif
 
 #define ASSERT_BLOCK(r, w, h) \
 	ASSERT((r).width() >= (w) && (r).height() >= (h) && !((r).left & ((w) - 1)) && !((r).top & ((h) - 1)) && !((r).right & ((w) - 1)) && !((r).bottom & ((h) - 1))); \
@@ -419,6 +423,33 @@ GSLocalMemory::GSLocalMemory()
 	m_psm[PSM_PSMZ16].rtxbP = &GSLocalMemory::ReadTextureBlock16;
 	m_psm[PSM_PSMZ16S].rtxbP = &GSLocalMemory::ReadTextureBlock16;
 
+#ifdef ENABLE_AVX512
+
+	// the 32 and 16 bits columns fit in one zmm register, see GSBlockAVX512.h
+
+	if(g_cpu.has(Xbyak::util::Cpu::tAVX512F) && g_cpu.has(Xbyak::util::Cpu::tAVX512BW))
+	{
+		m_psm[PSM_PSMCT32].rtx = m_psm[PSM_PSMCT32].rtxP = &GSLocalMemory::ReadTexture32AVX512;
+		m_psm[PSM_PSMCT24].rtx = m_psm[PSM_PSMCT24].rtxP = &GSLocalMemory::ReadTexture24AVX512;
+		m_psm[PSM_PSMCT16].rtx = m_psm[PSM_PSMCT16].rtxP = &GSLocalMemory::ReadTexture16AVX512;
+		m_psm[PSM_PSMCT16S].rtx = m_psm[PSM_PSMCT16S].rtxP = &GSLocalMemory::ReadTexture16AVX512;
+		m_psm[PSM_PSMZ32].rtx = m_psm[PSM_PSMZ32].rtxP = &GSLocalMemory::ReadTexture32AVX512;
+		m_psm[PSM_PSMZ24].rtx = m_psm[PSM_PSMZ24].rtxP = &GSLocalMemory::ReadTexture24AVX512;
+		m_psm[PSM_PSMZ16].rtx = m_psm[PSM_PSMZ16].rtxP = &GSLocalMemory::ReadTexture16AVX512;
+		m_psm[PSM_PSMZ16S].rtx = m_psm[PSM_PSMZ16S].rtxP = &GSLocalMemory::ReadTexture16AVX512;
+
+		m_psm[PSM_PSMCT32].rtxb = m_psm[PSM_PSMCT32].rtxbP = &GSLocalMemory::ReadTextureBlock32AVX512;
+		m_psm[PSM_PSMCT24].rtxb = m_psm[PSM_PSMCT24].rtxbP = &GSLocalMemory::ReadTextureBlock24AVX512;
+		m_psm[PSM_PSMCT16].rtxb = m_psm[PSM_PSMCT16].rtxbP = &GSLocalMemory::ReadTextureBlock16AVX512;
+		m_psm[PSM_PSMCT16S].rtxb = m_psm[PSM_PSMCT16S].rtxbP = &GSLocalMemory::ReadTextureBlock16AVX512;
+		m_psm[PSM_PSMZ32].rtxb = m_psm[PSM_PSMZ32].rtxbP = &GSLocalMemory::ReadTextureBlock32AVX512;
+		m_psm[PSM_PSMZ24].rtxb = m_psm[PSM_PSMZ24].rtxbP = &GSLocalMemory::ReadTextureBlock24AVX512;
+		m_psm[PSM_PSMZ16].rtxb = m_psm[PSM_PSMZ16].rtxbP = &GSLocalMemory::ReadTextureBlock16AVX512;
+		m_psm[PSM_PSMZ16S].rtxb = m_psm[PSM_PSMZ16S].rtxbP = &GSLocalMemory::ReadTextureBlock16AVX512;
+	}
+
+#endif
+
 	m_psm[PSM_PSGPU24].bpp = 16;
 	m_psm[PSM_PSMCT16].bpp = m_psm[PSM_PSMCT16S].bpp = 16;
 	m_psm[PSM_PSMT8].bpp = 8;
@@ -1772,6 +1803,39 @@ void GSLocalMemory::ReadTexture4HH(const GSOffset* RESTRICT off, const GSVector4
 	FOREACH_BLOCK_END
 }
 
+#ifdef ENABLE_AVX512
+
+// AVX-512 versions of the above, selected in the constructor
+
+void GSLocalMemory::ReadTexture32AVX512(const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 8, 8, 32)
+	{
+		GSBlockAVX512::ReadBlock32(src, read_dst, dstpitch);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemory::ReadTexture24AVX512(const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 8, 8, 32)
+	{
+		GSBlockAVX512::ReadAndExpandBlock24(src, read_dst, dstpitch, TEXA.TA0, TEXA.AEM);
+	}
+	FOREACH_BLOCK_END
+}
+
+void GSLocalMemory::ReadTexture16AVX512(const GSOffset* RESTRICT off, const GSVector4i& r, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA)
+{
+	FOREACH_BLOCK_START(r, 16, 8, 32)
+	{
+		GSBlockAVX512::ReadAndExpandBlock16(src, read_dst, dstpitch, TEXA.TA0, TEXA.TA1, TEXA.AEM);
+	}
+	FOREACH_BLOCK_END
+}
+
+#endif
+
 ///////////////////
 
 void GSLocalMemory::ReadTextureBlock32(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
@@ -1809,6 +1873,25 @@ void GSLocalMemory::ReadTextureBlock16(uint32 bp, uint8* dst, int dstpitch, cons
 	}
 }
 
+#ifdef ENABLE_AVX512
+
+void GSLocalMemory::ReadTextureBlock32AVX512(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	GSBlockAVX512::ReadBlock32(BlockPtr(bp), dst, dstpitch);
+}
+
+void GSLocalMemory::ReadTextureBlock24AVX512(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	GSBlockAVX512::ReadAndExpandBlock24(BlockPtr(bp), dst, dstpitch, TEXA.TA0, TEXA.AEM);
+}
+
+void GSLocalMemory::ReadTextureBlock16AVX512(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
+{
+	GSBlockAVX512::ReadAndExpandBlock16(BlockPtr(bp), dst, dstpitch, TEXA.TA0, TEXA.TA1, TEXA.AEM);
+}
+
+#endif
+
 void GSLocalMemory::ReadTextureBlock8(uint32 bp, uint8* dst, int dstpitch, const GIFRegTEXA& TEXA) const
 {
 	ALIGN_STACK(32);
@@ -20,6 +20,7 @@
 
 #include "stdafx.h"
 #include "GSLzma.h"
+#include "GSDump.h"
 
 GSDumpFile::GSDumpFile(char* filename, const char* repack_filename) {
 	m_fp = fopen(filename, "rb");
@@ -176,3 +177,188 @@ bool GSDumpRaw::Read(void* ptr, size_t size) {
 
 	return false;
 }
+
+/******************************************************************/
+
+GSDumpKeyframedFile::GSDumpKeyframedFile(char* filename, const char* repack_filename, uint32 start_frame) : GSDumpFile(filename, repack_filename) {
+	m_next        = 0;
+	m_pos         = 0;
+	m_first_frame = 0;
+
+	uint32 header[4];
+	if (fread(header, sizeof(header), 1, m_fp) != 1 || header[0] != GSDUMP_KEYFRAMED_MAGIC || header[1] != GSDUMP_KEYFRAMED_VERSION) {
+		fprintf(stderr, "%s isn't a keyframed dump\n", filename);
+		throw "BAD"; // Just exit the program
+	}
+
+	// Trailer and index, at the end of the file
+
+	uint64 index_offset;
+	uint32 trailer[2];
+	if (fseek(m_fp, -16, SEEK_END) != 0 || fread(&index_offset, 8, 1, m_fp) != 1 || fread(trailer, 8, 1, m_fp) != 1 || trailer[1] != GSDUMP_KEYFRAMED_INDEX_MAGIC) {
+		fprintf(stderr, "%s has no block index, the dump was not finished\n", filename);
+		throw "BAD"; // Just exit the program
+	}
+
+	std::vector<GSDumpBlockIndex> index(trailer[0]);
+	Seek(index_offset);
+	if (index.empty() || fread(index.data(), sizeof(GSDumpBlockIndex), index.size(), m_fp) != index.size()) {
+		fprintf(stderr, "Failed to read the block index of %s\n", filename);
+		throw "BAD"; // Just exit the program
+	}
+
+	size_t first = 0;
+	while (first + 1 < index.size() && index[first + 1].frame <= start_frame)
+		first++;
+
+	m_first_frame = index[first].frame;
+	m_index.assign(index.begin() + first, index.end());
+
+	// The compressed blocks follow each other, they are read sequentially from here
+
+	Seek(m_index[0].offset);
+
+	// The crc comes first in the stream, it is already "decompressed"
+
+	std::shared_ptr<Block> crc = std::make_shared<Block>();
+	crc->out.resize(4);
+	memcpy(crc->out.data(), &header[2], 4);
+	crc->start = 0;
+	crc->frame = m_first_frame;
+	crc->keyframe = true;
+	crc->error = false;
+	crc->done = true;
+	m_blocks.push_back(crc);
+
+	size_t threads = std::max<size_t>(std::min<size_t>(std::thread::hardware_concurrency(), MaxInFlight), 1);
+	for (size_t i = 0; i < threads; i++)
+		m_workers.push_back(std::unique_ptr<GSJobQueue<std::shared_ptr<Block>, 16>>(new GSJobQueue<std::shared_ptr<Block>, 16>([this](std::shared_ptr<Block>& block) { Decompress(block); })));
+
+	Submit();
+
+	fprintf(stderr, "Keyframed dump: starting at the keyframe of frame %u (%zu blocks of %u frames)\n", m_first_frame, m_index.size(), header[3]);
+}
+
+GSDumpKeyframedFile::~GSDumpKeyframedFile() {
+	// Let the workers finish what they have before the blocks and the lock go away
+	m_workers.clear();
+}
+
+void GSDumpKeyframedFile::Seek(uint64 offset) {
+#ifdef _WIN32
+	typedef __int64 file_offset;
+#else
+	typedef off_t file_offset;
+#endif
+
+	if (offset > (uint64)std::numeric_limits<file_offset>::max()) {
+		fprintf(stderr, "Seek error: offset %llu is out of range\n", (unsigned long long)offset);
+		throw "BAD"; // Just exit the program
+	}
+
+#ifdef _WIN32
+	int ret = _fseeki64(m_fp, (file_offset)offset, SEEK_SET);
+#else
+	int ret = fseeko(m_fp, (file_offset)offset, SEEK_SET);
+#endif
+
+	if (ret != 0) {
+		fprintf(stderr, "Seek error: %s\n", strerror(errno));
+		throw "BAD"; // Just exit the program
+	}
+}
+
+// Reads the next compressed blocks and hands them to the workers, until MaxInFlight
+// blocks are waiting to be read
+void GSDumpKeyframedFile::Submit() {
+	while (m_blocks.size() < MaxInFlight && m_next < m_index.size()) {
+		std::shared_ptr<Block> block = std::make_shared<Block>();
+		block->in.resize(m_index[m_next].compressed_size);
+		block->out.resize(m_index[m_next].size);
+		block->start = 0;
+		block->frame = m_index[m_next].frame;
+		block->keyframe = m_next == 0;
+		block->error = false;
+		block->done = false;
+
+		if (fread(block->in.data(), 1, block->in.size(), m_fp) != block->in.size()) {
+			fprintf(stderr, "Read error: %s\n", strerror(errno));
+			throw "BAD"; // Just exit the program
+		}
+
+		m_blocks.push_back(block);
+		m_workers[m_next % m_workers.size()]->Push(block);
+		m_next++;
+	}
+}
+
+void GSDumpKeyframedFile::Decompress(std::shared_ptr<Block>& block) {
+	uint64_t memlimit = UINT64_MAX;
+	size_t in_pos = 0;
+	size_t out_pos = 0;
+
+	lzma_ret ret = lzma_stream_buffer_decode(&memlimit, 0, NULL, block->in.data(), &in_pos, block->in.size(), block->out.data(), &out_pos, block->out.size());
+	if (ret != LZMA_OK || out_pos != block->out.size()) {
+		fprintf(stderr, "Decoder error: block of frame %u (error code %u)\n", block->frame, ret);
+		block->error = true;
+	}
+
+	// Only the first block keeps its keyframe, the following ones continue the stream
+	if (!block->keyframe && block->out.size() >= 4) {
+		uint32 state_size;
+		memcpy(&state_size, block->out.data(), 4);
+		block->start = std::min<size_t>(block->out.size(), 4 + state_size + 0x2000);
+	}
+
+	std::vector<uint8>().swap(block->in);
+
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+		block->done = true;
+	}
+	m_decompressed.notify_all();
+}
+
+bool GSDumpKeyframedFile::IsEof() {
+	return m_blocks.empty();
+}
+
+bool GSDumpKeyframedFile::Read(void* ptr, size_t size) {
+	size_t off = 0;
+	uint8_t* dst = (uint8_t*)ptr;
+	size_t full_size = size;
+	while (size && !IsEof()) {
+		const Block& block = *m_blocks.front();
+
+		if (!block.done) {
+			std::unique_lock<std::mutex> l(m_lock);
+			while (!block.done)
+				m_decompressed.wait(l);
+		}
+
+		if (block.error)
+			throw "BAD"; // Just exit the program
+
+		if (m_pos < block.start)
+			m_pos = block.start;
+
+		size_t l = std::min(size, block.out.size() - m_pos);
+		memcpy(dst + off, block.out.data() + m_pos, l);
+		size    -= l;
+		m_pos   += l;
+		off     += l;
+
+		if (m_pos == block.out.size()) {
+			m_blocks.pop_front();
+			m_pos = 0;
+			Submit();
+		}
+	}
+
+	if (size == 0) {
+		Repack(ptr, full_size);
+		return true;
+	}
+
+	return false;
+}
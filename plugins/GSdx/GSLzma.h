@@ -18,6 +18,7 @@
  *
  */
 
+#include "GSDump.h"
 #include <lzma.h>
 
 class GSDumpFile {
@@ -75,3 +76,48 @@ class GSDumpRaw : public GSDumpFile {
 	bool IsEof() final;
 	bool Read(void* ptr, size_t size) final;
 };
+
+// Keyframed dump (.gsk, see GSDump.h). Only the blocks from the keyframe at or before
+// start_frame onwards are used, and they are read back as a regular .gs stream beginning
+// at that keyframe. Blocks are decompressed on demand by a few workers, at most
+// MaxInFlight of them ahead of the reader, and released once they have been read.
+class GSDumpKeyframedFile : public GSDumpFile {
+
+	struct Block
+	{
+		std::vector<uint8> in;
+		std::vector<uint8> out;
+		size_t start; // first byte of the stream, past the keyframe of all but the first block
+		uint32 frame;
+		bool keyframe;
+		bool error;
+		std::atomic<bool> done;
+	};
+
+	static const size_t MaxInFlight = 8;
+
+	std::vector<GSDumpBlockIndex> m_index;
+	size_t		m_next; // next block of m_index to read from the file
+	std::deque<std::shared_ptr<Block>> m_blocks; // front is the block being read
+
+	size_t		m_pos;
+	uint32		m_first_frame;
+
+	std::mutex m_lock;
+	std::condition_variable m_decompressed;
+	std::vector<std::unique_ptr<GSJobQueue<std::shared_ptr<Block>, 16>>> m_workers;
+
+	void Seek(uint64 offset);
+	void Submit();
+	void Decompress(std::shared_ptr<Block>& block);
+
+	public:
+
+	GSDumpKeyframedFile(char* filename, const char* repack_filename, uint32 start_frame);
+	virtual ~GSDumpKeyframedFile();
+
+	uint32 GetFirstFrame() const { return m_first_frame; }
+
+	bool IsEof() final;
+	bool Read(void* ptr, size_t size) final;
+};
@@ -31,6 +31,8 @@ GSPerfMon::GSPerfMon()
 	memset(m_stats, 0, sizeof(m_stats));
 	memset(m_total, 0, sizeof(m_total));
 	memset(m_begin, 0, sizeof(m_begin));
+
+	ResetAccumulated();
 }
 
 void GSPerfMon::Put(counter_t c, double val)
@@ -60,6 +62,7 @@ void GSPerfMon::Put(counter_t c, double val)
 	else
 	{
 		m_counters[c] += val;
+		m_acc_counters[c] += val;
 	}
 #endif
 }
@@ -98,7 +101,10 @@ void GSPerfMon::Stop(int timer)
 #ifndef DISABLE_PERF_MON
 	if(m_start[timer] > 0)
 	{
-		m_total[timer] += __rdtsc() - m_start[timer];
+		uint64 ticks = __rdtsc() - m_start[timer];
+
+		m_total[timer] += ticks;
+		m_acc_total[timer] += ticks;
 		m_start[timer] = 0;
 	}
 #endif
@@ -117,3 +123,9 @@ int GSPerfMon::CPU(int timer, bool reset)
 
 	return percent;
 }
+
+void GSPerfMon::ResetAccumulated()
+{
+	memset(m_acc_counters, 0, sizeof(m_acc_counters));
+	memset(m_acc_total, 0, sizeof(m_acc_total));
+}
@@ -24,25 +24,30 @@
 class GSPerfMon
 {
 public:
+	enum {MaxWorkers = 32};
+
 	enum timer_t 
 	{
 		Main, 
 		Sync, 
-		WorkerDraw0, WorkerDraw1, WorkerDraw2, WorkerDraw3, WorkerDraw4, WorkerDraw5, WorkerDraw6, WorkerDraw7, 
-		WorkerDraw8, WorkerDraw9, WorkerDraw10, WorkerDraw11, WorkerDraw12, WorkerDraw13, WorkerDraw14, WorkerDraw15, 
-		TimerLast,
+		TexHash, // SW texture cache content hashing
+		WorkerDraw0, // time each rasterizer thread spends drawing
+		WorkerIdle0 = WorkerDraw0 + MaxWorkers, // time each rasterizer thread waits for work
+		TimerLast = WorkerIdle0 + MaxWorkers,
 	};
 	
 	enum counter_t 
 	{
-		Frame, Prim, Draw, Swizzle, Unswizzle, Fillrate, Quad, SyncPoint,
+		Frame, Prim, Draw, Swizzle, Unswizzle, Fillrate, Quad, SyncPoint, Merged, Fence, HashHit, HashSaved, Hashed,
 		CounterLast,
 	};
 
 protected:
 	double m_counters[CounterLast];
 	double m_stats[CounterLast];
+	double m_acc_counters[CounterLast];
 	uint64 m_begin[TimerLast], m_total[TimerLast], m_start[TimerLast];
+	uint64 m_acc_total[TimerLast];
 	uint64 m_frame;
 	clock_t m_lastframe;
 	int m_count;
@@ -62,6 +67,12 @@ public:
 	void Start(int timer = Main);
 	void Stop(int timer = Main);
 	int CPU(int timer = Main, bool reset = true);
+
+	// Accumulated values are never cleared by Update()/CPU(), so they can be
+	// sampled over an arbitrary window (replay benchmark).
+	double GetAccumulated(counter_t c) {return m_acc_counters[c];}
+	uint64 GetAccumulatedTicks(int timer) {return m_acc_total[timer];}
+	void ResetAccumulated();
 };
 
 class GSPerfMonAutoTimer
@@ -44,6 +44,7 @@ GSRasterizer::GSRasterizer(IDrawScanline* ds, int id, int threads, GSPerfMon* pe
 	, m_ds(ds)
 	, m_id(id)
 	, m_threads(threads)
+	, m_clip(0, 0, 2048, 2048)
 {
 	memset(&m_pixels, 0, sizeof(m_pixels));
 
@@ -55,14 +56,9 @@ GSRasterizer::GSRasterizer(IDrawScanline* ds, int id, int threads, GSPerfMon* pe
 	int rows = (2048 >> m_thread_height) + 16;
 	m_scanline = (uint8*)_aligned_malloc(rows, 64);
 
-	int row = 0;
-
-	while(row < rows)
+	for(int row = 0; row < rows; row++)
 	{
-		for(int i = 0; i < threads; i++, row++)
-		{
-			m_scanline[row] = i == id ? 1 : 0;
-		}
+		m_scanline[row] = row % threads == id ? 1 : 0;
 	}
 }
 
@@ -116,6 +112,8 @@ int GSRasterizer::FindMyNextScanline(int top) const
 
 void GSRasterizer::Queue(const std::shared_ptr<GSRasterizerData>& data)
 {
+	GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerDraw0 + m_id);
+
 	Draw(data.get());
 }
 
@@ -133,8 +131,6 @@ int GSRasterizer::GetPixels(bool reset)
 
 void GSRasterizer::Draw(GSRasterizerData* data)
 {
-	GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerDraw0 + m_id);
-
 	if(data->vertex != NULL && data->vertex_count == 0 || data->index != NULL && data->index_count == 0) return;
 
 	m_pixels.actual = 0;
@@ -152,11 +148,11 @@ void GSRasterizer::Draw(GSRasterizerData* data)
 
 	uint32 tmp_index[] = {0, 1, 2};
 
-	bool scissor_test = !data->bbox.eq(data->bbox.rintersect(data->scissor));
+	m_scissor = data->scissor.rintersect(m_clip);
+	m_fscissor_x = GSVector4(m_scissor).xzxz();
+	m_fscissor_y = GSVector4(m_scissor).ywyw();
 
-	m_scissor = data->scissor;
-	m_fscissor_x = GSVector4(data->scissor).xzxz();
-	m_fscissor_y = GSVector4(data->scissor).ywyw();
+	bool scissor_test = !data->bbox.eq(data->bbox.rintersect(m_scissor));
 
 	switch(data->primclass)
 	{
@@ -1139,40 +1135,219 @@ void GSRasterizer::DrawEdge(int pixels, int left, int top, const GSVertexSW& sca
 
 GSRasterizerList::GSRasterizerList(int threads, GSPerfMon* perfmon)
 	: m_perfmon(perfmon)
+	, m_stats(new WorkerStats[threads])
+	, m_threads(threads)
+	, m_phases(threads)
+	, m_columns(threads > 1 ? 2 : 1)
+	, m_split(2048)
+	, m_layout_scissor(GSVector4i::zero())
+	, m_pending(0)
+	, m_waiting(false)
+	, m_exit(false)
 {
 	m_thread_height = compute_best_thread_height(threads);
 
 	int rows = (2048 >> m_thread_height) + 16;
 	m_scanline = (uint8*)_aligned_malloc(rows, 64);
 
-	int row = 0;
+	for(int row = 0; row < rows; row++)
+	{
+		m_scanline[row] = (uint8)(row % threads);
+	}
 
-	while(row < rows)
+	for(int i = 0; i < threads; i++)
 	{
-		for(int i = 0; i < threads; i++, row++)
-		{
-			m_scanline[row] = (uint8)i;
-		}
+		m_stats[i].tiles = 0;
+		m_stats[i].steals = 0;
 	}
 }
 
 GSRasterizerList::~GSRasterizerList()
 {
+	{
+		std::lock_guard<std::mutex> l(m_lock);
+
+		m_exit = true;
+	}
+
+	m_notempty.notify_all();
+
+	for(auto& t : m_workers)
+	{
+		t.join();
+	}
+
 	_aligned_free(m_scanline);
 }
 
+void GSRasterizerList::UpdateLayout(const GSVector4i& scissor)
+{
+	// nothing is queued, the columns can be moved
+
+	m_layout_scissor = scissor;
+
+	if(m_columns == 1)
+	{
+		return;
+	}
+
+	m_split = std::max<int>(((scissor.left + scissor.right) / 2 + 32) & ~63, 64);
+
+	for(size_t i = 0; i < m_tiles.size(); i++)
+	{
+		m_tiles[i]->r->SetClip(i % m_columns == 0 ? GSVector4i(0, 0, m_split, 2048) : GSVector4i(m_split, 0, 2048, 2048));
+	}
+}
+
 void GSRasterizerList::Queue(const std::shared_ptr<GSRasterizerData>& data)
 {
 	GSVector4i r = data->bbox.rintersect(data->scissor);
 
 	ASSERT(r.top >= 0 && r.top < 2048 && r.bottom >= 0 && r.bottom < 2048);
 
+	if(!data->scissor.eq(m_layout_scissor) && m_pending == 0)
+	{
+		UpdateLayout(data->scissor);
+	}
+
 	int top = r.top >> m_thread_height;
-	int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, top + m_workers.size());
+	int bottom = std::min<int>((r.bottom + (1 << m_thread_height) - 1) >> m_thread_height, top + m_phases);
+
+	int first = m_columns > 1 && r.left >= m_split ? 1 : 0;
+	int last = m_columns > 1 && r.right <= m_split ? 1 : m_columns;
+
+	int queued = 0;
 
 	while(top < bottom)
 	{
-		m_workers[m_scanline[top++]]->Push(data);
+		int phase = m_scanline[top++];
+
+		for(int i = first; i < last; i++)
+		{
+			Tile* tile = m_tiles[phase * m_columns + i].get();
+
+			m_pending++;
+
+			while(!tile->queue.push(data))
+			{
+				std::this_thread::yield();
+			}
+
+			queued++;
+		}
+	}
+
+	if(queued > 0)
+	{
+		{
+			std::lock_guard<std::mutex> l(m_lock);
+		}
+
+		for(int i = std::min<int>(queued, m_threads); i > 0; i--)
+		{
+			m_notempty.notify_one();
+		}
+	}
+}
+
+GSRasterizerList::Tile* GSRasterizerList::FindTile(int id)
+{
+	auto acquire = [](Tile* tile) -> bool
+	{
+		if(tile->queue.empty() || tile->busy || tile->busy.exchange(true, std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		if(tile->queue.empty())
+		{
+			tile->busy.store(false, std::memory_order_release);
+
+			return false;
+		}
+
+		return true;
+	};
+
+	size_t n = m_tiles.size();
+
+	for(size_t i = id; i < n; i += m_threads)
+	{
+		if(m_tiles[i]->home == id && acquire(m_tiles[i].get()))
+		{
+			return m_tiles[i].get();
+		}
+	}
+
+	// steal, each thread starts looking at a different place
+
+	for(size_t i = 0, j = id * n / m_threads; i < n; i++, j = (j + 1) % n)
+	{
+		if(acquire(m_tiles[j].get()))
+		{
+			return m_tiles[j].get();
+		}
+	}
+
+	return NULL;
+}
+
+void GSRasterizerList::DrainTile(int id, Tile* tile)
+{
+	std::shared_ptr<GSRasterizerData> item;
+
+	while(tile->queue.pop(item))
+	{
+		tile->r->Draw(item.get());
+
+		item.reset(); // before m_pending, Sync() returns when the data is released
+
+		if(--m_pending == 0 || m_waiting)
+		{
+			{
+				std::lock_guard<std::mutex> l(m_wait_lock);
+			}
+
+			m_empty.notify_all();
+		}
+	}
+
+	tile->busy.store(false, std::memory_order_release);
+
+	m_stats[id].tiles++;
+
+	if(tile->home != id)
+	{
+		m_stats[id].steals++;
+	}
+}
+
+void GSRasterizerList::ThreadProc(int id)
+{
+	while(true)
+	{
+		Tile* tile = FindTile(id);
+
+		if(tile == NULL)
+		{
+			GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerIdle0 + id);
+
+			std::unique_lock<std::mutex> l(m_lock);
+
+			while((tile = FindTile(id)) == NULL)
+			{
+				if(m_exit)
+				{
+					return;
+				}
+
+				m_notempty.wait(l);
+			}
+		}
+
+		GSPerfMonAutoTimer pmat(m_perfmon, GSPerfMon::WorkerDraw0 + id);
+
+		DrainTile(id, tile);
 	}
 }
 
@@ -1180,9 +1355,11 @@ void GSRasterizerList::Sync()
 {
 	if(!IsSynced())
 	{
-		for(size_t i = 0; i < m_workers.size(); i++)
+		std::unique_lock<std::mutex> l(m_wait_lock);
+
+		while(m_pending > 0)
 		{
-			m_workers[i]->Wait();
+			m_empty.wait(l);
 		}
 
 		m_perfmon->Put(GSPerfMon::SyncPoint, 1);
@@ -1191,25 +1368,51 @@ void GSRasterizerList::Sync()
 
 bool GSRasterizerList::IsSynced() const
 {
-	for(size_t i = 0; i < m_workers.size(); i++)
+	return m_pending == 0;
+}
+
+void GSRasterizerList::Wait(const std::function<bool ()>& done)
+{
+	if(done())
 	{
-		if(!m_workers[i]->IsEmpty())
-		{
-			return false;
-		}
+		return;
+	}
+
+	std::unique_lock<std::mutex> l(m_wait_lock);
+
+	// m_waiting is set before done() is checked again and the workers read it after the
+	// draw they completed has been released, so either done() sees the release or the
+	// worker notifies (it can't get m_wait_lock before we are waiting)
+
+	m_waiting = true;
+
+	while(!done() && m_pending > 0)
+	{
+		m_empty.wait(l);
 	}
 
-	return true;
+	m_waiting = false;
 }
 
 int GSRasterizerList::GetPixels(bool reset)
 {
 	int pixels = 0;
 
-	for(size_t i = 0; i < m_workers.size(); i++)
+	for(size_t i = 0; i < m_tiles.size(); i++)
 	{
-		pixels += m_r[i]->GetPixels(reset);
+		pixels += m_tiles[i]->r->GetPixels(reset);
 	}
 
 	return pixels;
 }
+
+void GSRasterizerList::PrintStats()
+{
+	for(int i = 0; i < m_threads; i++)
+	{
+		printf("worker %2d: %3d%% draw, %3d%% idle, %llu tiles, %llu stolen\n", i,
+			m_perfmon->CPU(GSPerfMon::WorkerDraw0 + i, false),
+			m_perfmon->CPU(GSPerfMon::WorkerIdle0 + i, false),
+			(uint64)m_stats[i].tiles, (uint64)m_stats[i].steals);
+	}
+}
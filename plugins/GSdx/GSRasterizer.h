@@ -118,6 +118,7 @@ public:
 	virtual void Queue(const std::shared_ptr<GSRasterizerData>& data) = 0;
 	virtual void Sync() = 0;
 	virtual bool IsSynced() const = 0;
+	virtual void Wait(const std::function<bool ()>& done) = 0; // until done() or synced, done() must turn true as queued draws complete
 	virtual int GetPixels(bool reset = true) = 0;
 	virtual void PrintStats() = 0;
 };
@@ -131,6 +132,7 @@ protected:
 	int m_threads;
 	int m_thread_height;
 	uint8* m_scanline;
+	GSVector4i m_clip;
 	GSVector4i m_scissor;
 	GSVector4 m_fscissor_x;
 	GSVector4 m_fscissor_y;
@@ -167,6 +169,8 @@ public:
 	__forceinline bool IsOneOfMyScanlines(int top, int bottom) const;
 	__forceinline int FindMyNextScanline(int top) const;
 
+	void SetClip(const GSVector4i& clip) {m_clip = clip;}
+
 	void Draw(GSRasterizerData* data);
 
 	// IRasterizer
@@ -174,30 +178,78 @@ public:
 	void Queue(const std::shared_ptr<GSRasterizerData>& data);
 	void Sync() {}
 	bool IsSynced() const {return true;}
+	void Wait(const std::function<bool ()>& done) {}
 	int GetPixels(bool reset);
 	void PrintStats() {m_ds->PrintStats();}
 };
 
+// Screen tiles are the bands of 1 << m_thread_height rows of a row phase (every
+// m_phases-th band, as GSRasterizer interleaves them) crossed with one of m_columns
+// ranges of columns. Each tile has its own GSRasterizer and FIFO of draws, and its pixels
+// are always drawn by the rasterizer of that tile, in the order of the draws, so tiles
+// don't need to be synchronized with each other and their data stays warm in the cache
+// of the thread which drew them last.
+//
+// Worker threads drain the tiles they're the home of first, then steal tiles with pending
+// draws from the other threads, so a thread which got the cheap rows of a frame helps the
+// others instead of waiting for them. A tile is drained by one thread at a time.
+//
+// Column ranges are aligned to 64 pixels (the scanline code reads and writes whole
+// blocks), and are only moved when every queue is empty.
+
 class GSRasterizerList : public IRasterizer
 {
 protected:
-	using GSWorker = GSJobQueue<std::shared_ptr<GSRasterizerData>, 65536>;
+	typedef ringbuffer_base<std::shared_ptr<GSRasterizerData>, 4096> GSTileQueue;
+
+	struct Tile
+	{
+		std::unique_ptr<GSRasterizer> r;
+		GSTileQueue queue;
+		std::atomic<bool> busy;
+		int home;
+	};
+
+	struct WorkerStats
+	{
+		std::atomic<uint64> tiles; // tiles drained
+		std::atomic<uint64> steals; // tiles drained which belong to another thread
+	};
 
 	GSPerfMon* m_perfmon;
-	// Worker threads depend on the rasterizers, so don't change the order.
-	std::vector<std::unique_ptr<GSRasterizer>> m_r;
-	std::vector<std::unique_ptr<GSWorker>> m_workers;
-	uint8* m_scanline;
+	// Worker threads depend on the tiles, so don't change the order.
+	std::vector<std::unique_ptr<Tile>> m_tiles;
+	std::vector<std::thread> m_workers;
+	std::unique_ptr<WorkerStats[]> m_stats;
+	uint8* m_scanline; // band => row phase
+	int m_threads;
 	int m_thread_height;
+	int m_phases;
+	int m_columns;
+	int m_split; // first column of the second column range
+	GSVector4i m_layout_scissor;
+
+	std::atomic<int> m_pending; // (draw, tile) pairs queued and not drawn yet
+	std::atomic<bool> m_waiting; // Wait() needs to hear about every completed pair, not only the last one
+	bool m_exit;
+	std::mutex m_lock;
+	std::condition_variable m_notempty;
+	std::mutex m_wait_lock;
+	std::condition_variable m_empty;
 
 	GSRasterizerList(int threads, GSPerfMon* perfmon);
 
+	Tile* FindTile(int id);
+	void DrainTile(int id, Tile* tile);
+	void ThreadProc(int id);
+	void UpdateLayout(const GSVector4i& scissor);
+
 public:
 	virtual ~GSRasterizerList();
 
 	template<class DS> static IRasterizer* Create(int threads, GSPerfMon* perfmon)
 	{
-		threads = std::max<int>(threads, 0);
+		threads = std::min<int>(std::max<int>(threads, 0), GSPerfMon::MaxWorkers);
 
 		if(threads == 0)
 		{
@@ -206,12 +258,20 @@ public:
 
 		GSRasterizerList* rl = new GSRasterizerList(threads, perfmon);
 
+		for(int i = 0; i < rl->m_phases * rl->m_columns; i++)
+		{
+			Tile* tile = new Tile();
+
+			tile->r = std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i / rl->m_columns, rl->m_phases, perfmon));
+			tile->busy = false;
+			tile->home = i % threads;
+
+			rl->m_tiles.push_back(std::unique_ptr<Tile>(tile));
+		}
+
 		for(int i = 0; i < threads; i++)
 		{
-			rl->m_r.push_back(std::unique_ptr<GSRasterizer>(new GSRasterizer(new DS(), i, threads, perfmon)));
-			auto &r = *rl->m_r[i];
-			rl->m_workers.push_back(std::unique_ptr<GSWorker>(new GSWorker(
-				[&r](std::shared_ptr<GSRasterizerData> &item) { r.Draw(item.get()); })));
+			rl->m_workers.push_back(std::thread(&GSRasterizerList::ThreadProc, rl, i));
 		}
 
 		return rl;
@@ -222,6 +282,7 @@ public:
 	void Queue(const std::shared_ptr<GSRasterizerData>& data);
 	void Sync();
 	bool IsSynced() const;
+	void Wait(const std::function<bool ()>& done);
 	int GetPixels(bool reset);
-	void PrintStats() {}
+	void PrintStats();
 };
@@ -380,13 +380,22 @@ void GSRenderer::VSync(int field)
 
 				int sum = 0;
 
-				for(int i = 0; i < 16; i++)
+				for(int i = 0; i < GSPerfMon::MaxWorkers; i++)
 				{
 					sum += m_perfmon.CPU(GSPerfMon::WorkerDraw0 + i);
 				}
 
 				s += format(" | %d%% CPU", sum);
 			}
+
+			double hashed = m_perfmon.Get(GSPerfMon::Hashed);
+
+			if(hashed > 0)
+			{
+				// per frame: pages found unchanged, decoding saved, and what hashing cost
+
+				s += format(" | %d H/%.2f/%.2f", (int)m_perfmon.Get(GSPerfMon::HashHit), m_perfmon.Get(GSPerfMon::HashSaved) / 1024, hashed / 1024);
+			}
 		}
 		else
 		{
@@ -462,8 +471,12 @@ void GSRenderer::VSync(int field)
 			fd.data = new uint8[fd.size];
 			Freeze(&fd, false);
 
+			int keyframe_interval = theApp.GetConfigI("dump_keyframe_interval");
+
 			if (m_control_key)
 				m_dump = std::unique_ptr<GSDumpBase>(new GSDump(m_snapshot, m_crc, fd, m_regs));
+			else if (keyframe_interval > 0)
+				m_dump = std::unique_ptr<GSDumpBase>(new GSDumpKeyframed(m_snapshot, m_crc, fd, m_regs, keyframe_interval));
 			else
 				m_dump = std::unique_ptr<GSDumpBase>(new GSDumpXz(m_snapshot, m_crc, fd, m_regs));
 
@@ -480,7 +493,20 @@ void GSRenderer::VSync(int field)
 	else if(m_dump)
 	{
 		if(m_dump->VSync(field, !m_control_key, m_regs))
+		{
 			m_dump.reset();
+		}
+		else if(m_dump->IsKeyframeDue())
+		{
+			GSFreezeData fd = {0, nullptr};
+			Freeze(&fd, true);
+			fd.data = new uint8[fd.size];
+			Freeze(&fd, false);
+
+			m_dump->Keyframe(fd, m_regs);
+
+			delete [] fd.data;
+		}
 	}
 
 	// capture
@@ -51,6 +51,8 @@ GSRendererSW::GSRendererSW(int threads)
 
 	m_rl = GSRasterizerList::Create<GSDrawScanline>(threads, &m_perfmon);
 
+	m_batch_draws = theApp.GetConfigB("sw_batch_draws");
+
 	m_output = (uint8*)_aligned_malloc(1024 * 1024 * sizeof(uint32), 32);
 
 	for (uint32 i = 0; i < countof(m_fzb_pages); i++) {
@@ -60,6 +62,11 @@ GSRendererSW::GSRendererSW(int threads)
 		m_tex_pages[i] = 0;
 	}
 
+	memset(m_fence_pages, 0, sizeof(m_fence_pages));
+	memset(m_fence_tex_pages, 0, sizeof(m_fence_tex_pages));
+	memset(m_syncs, 0, sizeof(m_syncs));
+	memset(m_fences, 0, sizeof(m_fences));
+
 	#define InitCVB2(P, Q) \
 		m_cvb[P][0][0][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 0, Q>; \
 		m_cvb[P][0][1][Q] = &GSRendererSW::ConvertVertexBuffer<P, 0, 1, Q>; \
@@ -87,6 +94,12 @@ GSRendererSW::GSRendererSW(int threads)
 
 GSRendererSW::~GSRendererSW()
 {
+	g_scanline_key_cache.Close(); // before m_rl, the used keys are collected from its GSDrawScanline objects
+
+	m_batch.reset(); // before m_tc, it releases the pages of its textures
+
+	PrintSyncStats();
+
 	delete m_tc;
 
 	for(size_t i = 0; i < countof(m_texture); i++)
@@ -108,6 +121,13 @@ void GSRendererSW::Reset()
 	GSRenderer::Reset();
 }
 
+void GSRendererSW::SetGameCRC(uint32 crc, int options)
+{
+	GSRenderer::SetGameCRC(crc, options);
+
+	g_scanline_key_cache.Open(crc, theApp.GetConfigB("sw_jit_cache"));
+}
+
 void GSRendererSW::VSync(int field)
 {
 	Sync(0); // IncAge might delete a cached texture in use
@@ -473,6 +493,13 @@ void GSRendererSW::Draw()
 		sd->m_syncpoint = SharedData::SyncSource;
 	}
 
+	// wait for the queued draws using the conflicting pages, before this draw uses them too
+
+	if(sd->m_syncpoint != SharedData::SyncNone)
+	{
+		Fence(sd->m_syncpoint == SharedData::SyncSource ? 4 : 5);
+	}
+
 	// addref source and target pages
 
 	sd->UsePages(fb_pages, m_context->offset.fb->psm, zb_pages, m_context->offset.zb->psm);
@@ -580,20 +607,10 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 {
 	SharedData* sd = (SharedData*)item.get();
 
-	if(sd->m_syncpoint == SharedData::SyncSource) 
-	{
-		Sync(4);
-	}
-
-	// update previously invalidated parts
+	// update previously invalidated parts (the pages drawn to by queued draws have been fenced in Draw)
 
 	sd->UpdateSource();
 
-	if(sd->m_syncpoint == SharedData::SyncTarget)
-	{
-		Sync(5);
-	}
-
 	if(LOG)
 	{
 		GSScanlineGlobalData& gd = ((SharedData*)item.get())->global;
@@ -608,7 +625,30 @@ void GSRendererSW::Queue(std::shared_ptr<GSRasterizerData>& item)
 		fflush(s_fp);
 	}
 
-	m_rl->Queue(item);
+	// Consecutive draws with the same state are appended to the last one, and go to the
+	// rasterizer threads as a single job. A draw with a sync point is never appended (its
+	// fence has flushed the batch), the pages used by the batch count as in use
+	// (see IsSynced) so the dependency checks see it like any queued draw.
+
+	if(m_batch && ((SharedData*)m_batch.get())->CanMerge(sd))
+	{
+		((SharedData*)m_batch.get())->m_merged.push_back(item);
+
+		m_perfmon.Put(GSPerfMon::Merged, 1);
+	}
+	else
+	{
+		FlushBatch();
+
+		m_batch = item;
+	}
+
+	if(!m_batch_draws || m_rl->IsSynced())
+	{
+		// nothing to wait for, don't keep the threads idle
+
+		FlushBatch();
+	}
 
 	// invalidate new parts rendered onto
 
@@ -631,6 +671,13 @@ void GSRendererSW::Sync(int reason)
 
 	GSPerfMonAutoTimer pmat(&m_perfmon, GSPerfMon::Sync);
 
+	if(reason >= 0 && reason < SyncReasonLast && !IsSynced())
+	{
+		m_syncs[reason]++;
+	}
+
+	FlushBatch();
+
 	uint64 t = __rdtsc();
 
 	m_rl->Sync();
@@ -663,6 +710,109 @@ void GSRendererSW::Sync(int reason)
 	m_perfmon.Put(GSPerfMon::Fillrate, pixels);
 }
 
+void GSRendererSW::FlushBatch()
+{
+	if(!m_batch)
+	{
+		return;
+	}
+
+	SharedData* sd = (SharedData*)m_batch.get();
+
+	if(!sd->m_merged.empty())
+	{
+		sd->MergeBuffers();
+	}
+
+	m_rl->Queue(m_batch);
+
+	m_batch.reset();
+}
+
+// Per-page fences: instead of waiting for the whole queue like Sync, only the draws using
+// the pages added by AddFence are waited for, the others keep the threads busy.
+
+void GSRendererSW::AddFence(uint32 page, bool tex)
+{
+	uint32 row = page >> 5;
+	uint32 col = 1 << (page & 31);
+
+	m_fence_pages[row] |= col;
+
+	if(tex)
+	{
+		m_fence_tex_pages[row] |= col;
+	}
+}
+
+bool GSRendererSW::IsFenceDone() const
+{
+	for(uint32 row = 0; row < countof(m_fence_pages); row++)
+	{
+		uint32 p = m_fence_pages[row];
+
+		unsigned long j;
+
+		while(_BitScanForward(&j, p))
+		{
+			p ^= 1U << j;
+
+			uint32 i = (row << 5) | j;
+
+			if(m_fzb_pages[i] != 0)
+			{
+				return false;
+			}
+
+			if((m_fence_tex_pages[row] & (1U << j)) && m_tex_pages[i] != 0)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void GSRendererSW::Fence(int reason)
+{
+	GSPerfMonAutoTimer pmat(&m_perfmon, GSPerfMon::Sync);
+
+	if(!IsFenceDone())
+	{
+		FlushBatch(); // its pages can't be released before it's drawn
+
+		m_rl->Wait([this]() {return IsFenceDone();});
+
+		m_fences[reason]++;
+
+		m_perfmon.Put(GSPerfMon::Fence, 1);
+
+		if(LOG) {fprintf(s_fp, "fence n=%d r=%d\n", s_n, reason); fflush(s_fp);}
+	}
+
+	memset(m_fence_pages, 0, sizeof(m_fence_pages));
+	memset(m_fence_tex_pages, 0, sizeof(m_fence_tex_pages));
+}
+
+void GSRendererSW::PrintSyncStats()
+{
+	static const char* names[SyncReasonLast] = {"vsync", "output", "dump", "dump", "source", "target", "upload", "readback"};
+
+	std::string syncs, fences;
+
+	for(int i = 0; i < SyncReasonLast; i++)
+	{
+		if(m_syncs[i]) syncs += format(" %s %u", names[i], m_syncs[i]);
+		if(m_fences[i]) fences += format(" %s %u", names[i], m_fences[i]);
+	}
+
+	if(!syncs.empty() || !fences.empty())
+	{
+		printf("GSdx: SW renderer syncs:%s, page fences:%s\n", syncs.empty() ? " none" : syncs.c_str(), fences.empty() ? " none" : fences.c_str());
+	}
+}
+
 void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r)
 {
 	if(LOG) {fprintf(s_fp, "w %05x %u %u, %d %d %d %d\n", BITBLTBUF.DBP, BITBLTBUF.DBW, BITBLTBUF.DPSM, r.x, r.y, r.z, r.w); fflush(s_fp);}
@@ -673,17 +823,24 @@ void GSRendererSW::InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 
 	// check if the changing pages either used as a texture or a target
 
-	if(!m_rl->IsSynced())
+	if(!IsSynced())
 	{
+		bool used = false;
+
 		for(uint32* RESTRICT p = m_tmp_pages; *p != GSOffset::EOP; p++)
 		{
 			if(m_fzb_pages[*p] | m_tex_pages[*p])
 			{
-				Sync(6);
+				AddFence(*p, true);
 
-				break;
+				used = true;
 			}
 		}
+
+		if(used)
+		{
+			Fence(6);
+		}
 	}
 
 	m_tc->InvalidatePages(m_tmp_pages, off->psm); // if texture update runs on a thread and Sync(5) happens then this must come later
@@ -693,21 +850,28 @@ void GSRendererSW::InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GS
 {
 	if(LOG) {fprintf(s_fp, "%s %05x %u %u, %d %d %d %d\n", clut ? "rp" : "r", BITBLTBUF.SBP, BITBLTBUF.SBW, BITBLTBUF.SPSM, r.x, r.y, r.z, r.w); fflush(s_fp);}
 
-	if(!m_rl->IsSynced())
+	if(!IsSynced())
 	{
 		GSOffset* off = m_mem.GetOffset(BITBLTBUF.SBP, BITBLTBUF.SBW, BITBLTBUF.SPSM);
 
 		off->GetPages(r, m_tmp_pages);
 
+		bool used = false;
+
 		for(uint32* RESTRICT p = m_tmp_pages; *p != GSOffset::EOP; p++)
 		{
 			if(m_fzb_pages[*p])
 			{
-				Sync(7);
+				AddFence(*p, false);
 
-				break;
+				used = true;
 			}
 		}
+
+		if(used)
+		{
+			Fence(7);
+		}
 	}
 }
 
@@ -755,7 +919,7 @@ void GSRendererSW::ReleasePages(const uint32* pages, const int type)
 
 bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pages, const GSVector4i& r)
 {
-	bool synced = m_rl->IsSynced();
+	bool synced = IsSynced();
 
 	bool fb = fb_pages != NULL;
 	bool zb = zb_pages != NULL;
@@ -785,8 +949,12 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 			m_fzb_cur_pages[row] |= col;
 
-			used |= m_fzb_pages[i];
-			used |= m_tex_pages[i];
+			if(m_fzb_pages[i] | m_tex_pages[i])
+			{
+				AddFence(i, true);
+
+				used = 1;
+			}
 		}
 
 		for(const uint32* p = zb_pages; *p != GSOffset::EOP; p++)
@@ -798,8 +966,12 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 			m_fzb_cur_pages[row] |= col;
 
-			used |= m_fzb_pages[i];
-			used |= m_tex_pages[i];
+			if(m_fzb_pages[i] | m_tex_pages[i])
+			{
+				AddFence(i, true);
+
+				used = 1;
+			}
 		}
 
 		if(!synced)
@@ -844,7 +1016,12 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 				{
 					m_fzb_cur_pages[row] |= col;
 
-					used |= m_fzb_pages[i];
+					if(m_fzb_pages[i])
+					{
+						AddFence(i, false);
+
+						used = 1;
+					}
 				}
 			}
 
@@ -859,7 +1036,12 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 				{
 					m_fzb_cur_pages[row] |= col;
 
-					used |= m_fzb_pages[i];
+					if(m_fzb_pages[i])
+					{
+						AddFence(i, false);
+
+						used = 1;
+					}
 				}
 			}
 
@@ -879,32 +1061,32 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 			// chross-check frame and z-buffer pages, they cannot overlap with eachother and with previous batches in queue,
 			// have to be careful when the two buffers are mutually enabled/disabled and alternating (Bully FBP/ZBP = 0x2300)
 
-			if(fb && !res)
+			if(fb)
 			{
 				for(const uint32* p = fb_pages; *p != GSOffset::EOP; p++)
 				{
 					if(m_fzb_pages[*p] & 0xffff0000)
 					{
-						if(LOG) {fprintf(s_fp, "syncpoint 2\n"); fflush(s_fp);}
+						if(LOG && !res) {fprintf(s_fp, "syncpoint 2\n"); fflush(s_fp);}
 
-						res = true;
+						AddFence(*p, false);
 
-						break;
+						res = true;
 					}
 				}
 			}
 
-			if(zb && !res)
+			if(zb)
 			{
 				for(const uint32* p = zb_pages; *p != GSOffset::EOP; p++)
 				{
 					if(m_fzb_pages[*p] & 0x0000ffff)
 					{
-						if(LOG) {fprintf(s_fp, "syncpoint 3\n"); fflush(s_fp);}
+						if(LOG && !res) {fprintf(s_fp, "syncpoint 3\n"); fflush(s_fp);}
 
-						res = true;
+						AddFence(*p, false);
 
-						break;
+						res = true;
 					}
 				}
 			}
@@ -919,7 +1101,9 @@ bool GSRendererSW::CheckTargetPages(const uint32* fb_pages, const uint32* zb_pag
 
 bool GSRendererSW::CheckSourcePages(SharedData* sd)
 {
-	if(!m_rl->IsSynced())
+	bool res = false;
+
+	if(!IsSynced())
 	{
 		for(size_t i = 0; sd->m_tex[i].t != NULL; i++)
 		{
@@ -931,15 +1115,17 @@ bool GSRendererSW::CheckSourcePages(SharedData* sd)
 			{
 				// TODO: 8H 4HL 4HH texture at the same place as the render target (24 bit, or 32-bit where the alpha channel is masked, Valkyrie Profile 2)
 
-				if(m_fzb_pages[*p]) // currently being drawn to? => sync
+				if(m_fzb_pages[*p]) // currently being drawn to? => wait for the draws using it
 				{
-					return true;
+					AddFence(*p, false);
+
+					res = true;
 				}
 			}
 		}
 	}
 
-	return false;
+	return res;
 }
 
 #include "GSTextureSW.h"
@@ -1420,7 +1606,7 @@ GSRendererSW::SharedData::SharedData(GSRendererSW* parent)
 {
 	m_tex[0].t = NULL;
 
-	global.sel.key = 0;
+	memset((void*)&global, 0, sizeof(global)); // padding and unused fields too, CanMerge compares it as a whole
 
 	global.clut = NULL;
 	global.dimx = NULL;
@@ -1507,6 +1693,110 @@ void GSRendererSW::SharedData::ReleasePages()
 	m_using_pages = false;
 }
 
+bool GSRendererSW::SharedData::CanMerge(const SharedData* sd) const
+{
+	if(sd->m_syncpoint != SyncNone || sd->primclass != primclass || !sd->scissor.eq(scissor))
+	{
+		return false;
+	}
+
+	// don't let a batch grow too big, the threads would wait for it at the next sync
+
+	if(m_merged.size() >= 256 || vertex_count + sd->vertex_count > 0x10000)
+	{
+		return false;
+	}
+
+	for(size_t i = 0; i < countof(m_tex); i++)
+	{
+		if(m_tex[i].t != sd->m_tex[i].t)
+		{
+			return false;
+		}
+
+		if(m_tex[i].t == NULL)
+		{
+			break;
+		}
+	}
+
+	// clut and dimx are copies, compare their contents
+
+	if((global.clut != NULL) != (sd->global.clut != NULL) || (global.clut != NULL && memcmp(global.clut, sd->global.clut, sizeof(uint32) * 256) != 0))
+	{
+		return false;
+	}
+
+	if((global.dimx != NULL) != (sd->global.dimx != NULL) || (global.dimx != NULL && memcmp(global.dimx, sd->global.dimx, sizeof(GSVector4i) * 8) != 0))
+	{
+		return false;
+	}
+
+	const uint8* a = (const uint8*)&global;
+	const uint8* b = (const uint8*)&sd->global;
+
+	size_t clut = offsetof(GSScanlineGlobalData, clut);
+	size_t end = offsetof(GSScanlineGlobalData, fbr);
+
+	return memcmp(a, b, clut) == 0 && memcmp(a + end, b + end, sizeof(global) - end) == 0;
+}
+
+// Appends the vertices and indices of the merged draws
+void GSRendererSW::SharedData::MergeBuffers()
+{
+	int vertices = vertex_count;
+	int indices = index_count;
+
+	for(const auto& i : m_merged)
+	{
+		vertices += i->vertex_count;
+		indices += i->index_count;
+	}
+
+	size_t vertex_size = sizeof(GSVertexSW) * ((vertices + 1) & ~1);
+
+	uint8* merged = (uint8*)_aligned_malloc(vertex_size + sizeof(uint32) * indices, 64);
+
+	GSVertexSW* v = (GSVertexSW*)merged;
+	uint32* RESTRICT dst = (uint32*)(merged + vertex_size);
+
+	memcpy(merged, vertex, sizeof(GSVertexSW) * vertex_count);
+	memcpy(dst, index, sizeof(uint32) * index_count);
+
+	int base = vertex_count;
+
+	dst += index_count;
+
+	for(const auto& i : m_merged)
+	{
+		memcpy(merged + sizeof(GSVertexSW) * base, i->vertex, sizeof(GSVertexSW) * i->vertex_count);
+
+		for(int j = 0; j < i->index_count; j++)
+		{
+			dst[j] = i->index[j] + base;
+		}
+
+		base += i->vertex_count;
+		dst += i->index_count;
+
+		bbox = bbox.runion(i->bbox);
+
+		_aligned_free(i->buff);
+
+		i->buff = NULL;
+		i->vertex = NULL;
+		i->index = NULL;
+	}
+
+	_aligned_free(buff);
+
+	buff = merged;
+	vertex = v;
+	vertex_count = vertices;
+	index = (uint32*)(merged + vertex_size);
+	index_count = indices;
+}
+
 void GSRendererSW::SharedData::SetSource(GSTextureCacheSW::Texture* t, const GSVector4i& r, int level)
 {
 	ASSERT(m_tex[level].t == NULL);
@@ -49,6 +49,7 @@ class GSRendererSW : public GSRenderer
 		bool m_using_pages;
 		TextureLevel m_tex[7 + 1]; // NULL terminated
 		enum {SyncNone, SyncSource, SyncTarget} m_syncpoint;
+		std::vector<std::shared_ptr<GSRasterizerData>> m_merged; // draws appended to this one, they keep their pages in use until it's drawn
 
 	public:
 		SharedData(GSRendererSW* parent);
@@ -59,12 +60,17 @@ class GSRendererSW : public GSRenderer
 
 		void SetSource(GSTextureCacheSW::Texture* t, const GSVector4i& r, int level);
 		void UpdateSource();
+
+		bool CanMerge(const SharedData* sd) const;
+		void MergeBuffers();
 	};
 
 	typedef void (GSRendererSW::*ConvertVertexBufferPtr)(GSVertexSW* RESTRICT dst, const GSVertex* RESTRICT src, size_t count);
 
 	ConvertVertexBufferPtr m_cvb[4][2][2][2];
 
+	enum {SyncReasonLast = 8}; // Sync/Fence reasons are 0 to 7, Sync(-1) (reset) isn't counted
+
 	template<uint32 primclass, uint32 tme, uint32 fst, uint32 q_div>
 	void ConvertVertexBuffer(GSVertexSW* RESTRICT dst, const GSVertex* RESTRICT src, size_t count);
 
@@ -79,9 +85,16 @@ protected:
 	std::atomic<uint32> m_fzb_pages[512]; // uint16 frame/zbuf pages interleaved
 	std::atomic<uint16> m_tex_pages[512];
 	uint32 m_tmp_pages[512 + 1];
+	std::shared_ptr<GSRasterizerData> m_batch; // last draw, not passed to m_rl yet so that the next draws can be appended to it
+	bool m_batch_draws;
+	uint32 m_fence_pages[16]; // pages Fence() waits for until nothing draws to them, bit per page like m_fzb_cur_pages
+	uint32 m_fence_tex_pages[16]; // ... until nothing reads them either
+	uint32 m_syncs[SyncReasonLast]; // full syncs which had to wait, per reason
+	uint32 m_fences[SyncReasonLast]; // fences which had to wait, per reason
 
 	void Reset();
 	void VSync(int field);
+	void SetGameCRC(uint32 crc, int options);
 	void ResetDevice();
 	GSTexture* GetOutput(int i, int& y_offset);
 	GSTexture* GetFeedbackOutput();
@@ -89,6 +102,12 @@ protected:
 	void Draw();
 	void Queue(std::shared_ptr<GSRasterizerData>& item);
 	void Sync(int reason);
+	void FlushBatch();
+	void AddFence(uint32 page, bool tex);
+	bool IsFenceDone() const;
+	void Fence(int reason);
+	void PrintSyncStats();
+	bool IsSynced() const {return !m_batch && m_rl->IsSynced();}
 	void InvalidateVideoMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r);
 	void InvalidateLocalMem(const GIFRegBITBLTBUF& BITBLTBUF, const GSVector4i& r, bool clut = false);
 
@@ -22,9 +22,73 @@
 #include "stdafx.h"
 #include "GSTextureCacheSW.h"
 
+// Content hashing (sw_texture_hash): games often upload the same data again every frame (fonts,
+// hud). Instead of dropping the decoded blocks, the written pages are only marked dirty, and the
+// next Update of a texture compares their hash with the one they had when they were decoded.
+
+// xxhash64 style, with four independent lanes so that the multiplications can overlap
+static uint64 HashPage(const uint8* RESTRICT src)
+{
+	const uint64 P1 = 11400714785074694791ull;
+	const uint64 P2 = 14029467366897019727ull;
+	const uint64 P3 = 1609587929392839161ull;
+	const uint64 P4 = 9650029242287828579ull;
+
+	#define ROTL64(x, r) (((x) << (r)) | ((x) >> (64 - (r))))
+	#define ROUND64(acc, v) acc = ROTL64(acc + (v) * P2, 31) * P1
+
+	const uint64* RESTRICT s = (const uint64*)src;
+
+	uint64 v0 = P1 + P2;
+	uint64 v1 = P2;
+	uint64 v2 = 0;
+	uint64 v3 = 0 - P1;
+
+	for(size_t i = 0; i < PAGE_SIZE / sizeof(uint64); i += 4)
+	{
+		ROUND64(v0, s[i + 0]);
+		ROUND64(v1, s[i + 1]);
+		ROUND64(v2, s[i + 2]);
+		ROUND64(v3, s[i + 3]);
+	}
+
+	uint64 h = ROTL64(v0, 1) + ROTL64(v1, 7) + ROTL64(v2, 12) + ROTL64(v3, 18);
+
+	uint64 m;
+
+	m = 0; ROUND64(m, v0); h = (h ^ m) * P1 + P4;
+	m = 0; ROUND64(m, v1); h = (h ^ m) * P1 + P4;
+	m = 0; ROUND64(m, v2); h = (h ^ m) * P1 + P4;
+	m = 0; ROUND64(m, v3); h = (h ^ m) * P1 + P4;
+
+	h += PAGE_SIZE;
+
+	h ^= h >> 33;
+	h *= P2;
+	h ^= h >> 29;
+	h *= P3;
+	h ^= h >> 32;
+
+	#undef ROUND64
+	#undef ROTL64
+
+	return h != 0 ? h : 1; // 0 means unknown in Texture::m_hash
+}
+
+static __forceinline int CountBits(uint32 v)
+{
+	v = v - ((v >> 1) & 0x55555555);
+	v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+
+	return (((v + (v >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+}
+
 GSTextureCacheSW::GSTextureCacheSW(GSState* state)
 	: m_state(state)
 {
+	m_hashing = theApp.GetConfigB("sw_texture_hash");
+
+	memset(m_page_hash_valid, 0, sizeof(m_page_hash_valid));
 }
 
 GSTextureCacheSW::~GSTextureCacheSW()
@@ -64,7 +128,7 @@ GSTextureCacheSW::Texture* GSTextureCacheSW::Lookup(const GIFRegTEX0& TEX0, cons
 	}
 
 	// Lookup miss
-	Texture* t = new Texture(m_state, tw0, TEX0, TEXA);
+	Texture* t = new Texture(m_state, this, tw0, TEX0, TEXA);
 
 	m_textures.insert(t);
 
@@ -82,23 +146,23 @@ void GSTextureCacheSW::InvalidatePages(const uint32* pages, uint32 psm)
 	for(const uint32* p = pages; *p != GSOffset::EOP; p++)
 	{
 		const uint32 page = *p;
-		
+
+		uint32 row = page >> 5;
+		uint32 col = 1 << (page & 31);
+
+		m_page_hash_valid[row] &= ~col;
+
 		for(Texture* t : m_map[page])
 		{
 			if(GSUtil::HasSharedBits(psm, t->m_sharedbits))
 			{
-				uint32* RESTRICT valid = t->m_valid;
-
-				if(t->m_repeating)
+				if(m_hashing)
 				{
-					for(const GSVector2i& j : t->m_p2t[page])
-					{
-						valid[j.x] &= j.y;
-					}
+					t->m_dirty[row] |= col; // the data is written after this, see Texture::CheckDirtyPages
 				}
 				else
 				{
-					valid[page] = 0;
+					t->InvalidatePage(page);
 				}
 
 				t->m_complete = false;
@@ -107,6 +171,24 @@ void GSTextureCacheSW::InvalidatePages(const uint32* pages, uint32 psm)
 	}
 }
 
+uint64 GSTextureCacheSW::GetPageHash(uint32 page)
+{
+	uint32 row = page >> 5;
+	uint32 col = 1 << (page & 31);
+
+	if((m_page_hash_valid[row] & col) == 0)
+	{
+		GSPerfMonAutoTimer pmat(&m_state->m_perfmon, GSPerfMon::TexHash);
+
+		m_page_hash[page] = HashPage(&m_state->m_mem.m_vm8[page * PAGE_SIZE]);
+		m_page_hash_valid[row] |= col;
+
+		m_state->m_perfmon.Put(GSPerfMon::Hashed, PAGE_SIZE);
+	}
+
+	return m_page_hash[page];
+}
+
 void GSTextureCacheSW::RemoveAll()
 {
 	for(auto i : m_textures) delete i;
@@ -146,8 +228,9 @@ void GSTextureCacheSW::IncAge()
 
 //
 
-GSTextureCacheSW::Texture::Texture(GSState* state, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
+GSTextureCacheSW::Texture::Texture(GSState* state, GSTextureCacheSW* cache, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA)
 	: m_state(state)
+	, m_cache(cache)
 	, m_buff(NULL)
 	, m_tw(tw0)
 	, m_age(0)
@@ -163,6 +246,7 @@ GSTextureCacheSW::Texture::Texture(GSState* state, uint32 tw0, const GIFRegTEX0&
 	}
 
 	memset(m_valid, 0, sizeof(m_valid));
+	memset(m_dirty, 0, sizeof(m_dirty));
 
 	m_sharedbits = GSUtil::HasSharedBitsPtr(m_TEX0.PSM);
 
@@ -189,6 +273,98 @@ GSTextureCacheSW::Texture::~Texture()
 	}
 }
 
+void GSTextureCacheSW::Texture::InvalidatePage(uint32 page)
+{
+	uint32* RESTRICT valid = m_valid;
+
+	if(m_repeating)
+	{
+		for(const GSVector2i& j : m_p2t[page])
+		{
+			valid[j.x] &= j.y;
+		}
+	}
+	else
+	{
+		valid[page] = 0;
+	}
+}
+
+// Checks the dirty pages under r (already aligned to blocks), the ones Update is about to read.
+// The others may still be drawn to by queued draws (the renderer only waits for the pages under
+// r), they stay dirty until an update covers them.
+
+void GSTextureCacheSW::Texture::CheckDirtyPages(const GSVector4i& r)
+{
+	uint32 dirty = 0;
+
+	for(size_t i = 0; i < countof(m_dirty); i++)
+	{
+		dirty |= m_dirty[i];
+	}
+
+	if(dirty == 0)
+	{
+		return;
+	}
+
+	if(m_hash.empty())
+	{
+		m_hash.resize(MAX_PAGES, 0);
+	}
+
+	const GSLocalMemory::psm_t& psm = GSLocalMemory::m_psm[m_TEX0.PSM];
+
+	int block_size = (psm.bs.x * psm.bs.y) << (psm.pal == 0 ? 2 : 0); // decoded
+
+	uint32 pages[MAX_PAGES + 1];
+
+	m_offset->GetPages(r, pages);
+
+	for(const uint32* p = pages; *p != GSOffset::EOP; p++)
+	{
+		uint32 page = *p;
+
+		uint32 row = page >> 5;
+		uint32 col = 1 << (page & 31);
+
+		if((m_dirty[row] & col) == 0)
+		{
+			continue;
+		}
+
+		m_dirty[row] &= ~col;
+
+		uint64 hash = m_cache->GetPageHash(page);
+
+		if(m_hash[page] == hash)
+		{
+			int blocks = 0;
+
+			if(m_repeating)
+			{
+				for(const GSVector2i& j : m_p2t[page])
+				{
+					blocks += CountBits(m_valid[j.x] & ~j.y);
+				}
+			}
+			else
+			{
+				blocks = CountBits(m_valid[page]);
+			}
+
+			m_state->m_perfmon.Put(GSPerfMon::HashHit, 1);
+			m_state->m_perfmon.Put(GSPerfMon::HashSaved, blocks * block_size);
+		}
+		else
+		{
+			InvalidatePage(page);
+
+			m_hash[page] = hash; // decoded from now on
+		}
+	}
+}
+
 bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 {
 	if(m_complete)
@@ -209,6 +385,11 @@ bool GSTextureCacheSW::Texture::Update(const GSVector4i& rect)
 
 	r = r.ralign<Align_Outside>(bs);
 
+	if(m_cache->m_hashing)
+	{
+		CheckDirtyPages(r);
+	}
+
 	if(r.eq(GSVector4i(0, 0, tw, th)))
 	{
 		m_complete = true; // lame, but better than nothing
@@ -31,6 +31,7 @@ public:
 	{
 	public:
 		GSState* m_state;
+		GSTextureCacheSW* m_cache;
 		GSOffset* m_offset;
 		GIFRegTEX0 m_TEX0;
 		GIFRegTEXA m_TEXA;
@@ -44,14 +45,18 @@ public:
 		std::array<uint16, MAX_PAGES> m_erase_it;
 		struct {uint32 bm[16]; const uint32* n;} m_pages;
 		const uint32* RESTRICT m_sharedbits;
+		uint32 m_dirty[MAX_PAGES / 32]; // content hashing: pages written to since they were decoded, Update checks them against m_hash
+		std::vector<uint64> m_hash; // content hashing: hash of each page when its valid blocks were decoded, 0 if unknown
 
 		// m_valid
 		// fast mode: each uint32 bits map to the 32 blocks of that page
 		// repeating mode: 1 bpp image of the texture tiles (8x8), also having 512 elements is just a coincidence (worst case: (1024*1024)/(8*8)/(sizeof(uint32)*8))
 
-		Texture(GSState* state, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
+		Texture(GSState* state, GSTextureCacheSW* cache, uint32 tw0, const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA);
 		virtual ~Texture();
 
+		void InvalidatePage(uint32 page);
+		void CheckDirtyPages(const GSVector4i& r);
 		bool Update(const GSVector4i& r);
 		bool Save(const std::string& fn, bool dds = false) const;
 	};
@@ -60,6 +65,9 @@ protected:
 	GSState* m_state;
 	std::unordered_set<Texture*> m_textures;
 	std::array<FastList<Texture*>, MAX_PAGES> m_map;
+	bool m_hashing;
+	uint64 m_page_hash[MAX_PAGES];
+	uint32 m_page_hash_valid[MAX_PAGES / 32]; // m_page_hash is up to date, cleared when the page is written to
 
 public:
 	GSTextureCacheSW(GSState* state);
@@ -68,6 +76,7 @@ public:
 	Texture* Lookup(const GIFRegTEX0& TEX0, const GIFRegTEXA& TEXA, uint32 tw0 = 0);
 
 	void InvalidatePages(const uint32* pages, uint32 psm);
+	uint64 GetPageHash(uint32 page);
 
 	void RemoveAll();
 	void IncAge();
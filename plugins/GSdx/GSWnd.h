@@ -56,6 +56,30 @@ public:
 
 };
 
+// Window-less target used by the headless replay benchmark. Pair it with
+// GSDeviceNull, nothing is ever presented.
+class GSWndNull : public GSWnd
+{
+	GSVector4i m_rect;
+
+public:
+	GSWndNull(int w = 640, int h = 480) : m_rect(0, 0, w, h) {};
+	virtual ~GSWndNull() {};
+
+	bool Create(const std::string& title, int w, int h) {m_rect = GSVector4i(0, 0, w, h); return true;}
+	bool Attach(void* handle, bool managed = true) {m_managed = managed; return true;}
+	void Detach() {}
+
+	void* GetDisplay() {return NULL;}
+	void* GetHandle() {return NULL;}
+	GSVector4i GetClientRect() {return m_rect;}
+	bool SetWindowText(const char* title) {return false;}
+
+	void Show() {}
+	void Hide() {}
+	void HideFrame() {}
+};
+
 class GSWndGL : public GSWnd
 {
 protected:
@@ -305,6 +305,9 @@ void GSdxApp::Init()
 	m_gs_tv_shaders.push_back(GSSetting(3, "Triangular filter", ""));
 	m_gs_tv_shaders.push_back(GSSetting(4, "Wave filter", ""));
 
+	m_gs_capture_format.push_back(GSSetting(0, "PNG", "Lossless, one file per frame"));
+	m_gs_capture_format.push_back(GSSetting(1, "Y4M", "Raw YUV 4:4:4, single file"));
+
 	m_gpu_renderers.push_back(GSSetting(static_cast<int8>(GPURendererType::D3D9_SW), "Direct3D 9", "Software"));
 	m_gpu_renderers.push_back(GSSetting(static_cast<int8>(GPURendererType::D3D11_SW), "Direct3D 11", "Software"));
 	m_gpu_renderers.push_back(GSSetting(static_cast<int8>(GPURendererType::NULL_Renderer), "Null", ""));
@@ -355,6 +358,7 @@ void GSdxApp::Init()
 	m_default_configuration["accurate_date"]                              = "0";
 	m_default_configuration["AspectRatio"]                                = "1";
 	m_default_configuration["capture_enabled"]                            = "0";
+	m_default_configuration["capture_format"]                             = "0";
 	m_default_configuration["capture_out_dir"]                            = "/tmp/GSdx_Capture";
 	m_default_configuration["capture_threads"]                            = "4";
 	m_default_configuration["CaptureHeight"]                              = "480";
@@ -366,6 +370,7 @@ void GSdxApp::Init()
 	m_default_configuration["debug_opengl"]                               = "0";
 	m_default_configuration["disable_hw_gl_draw"]                         = "0";
 	m_default_configuration["dump"]                                       = "0";
+	m_default_configuration["dump_keyframe_interval"]                     = "0";
 	m_default_configuration["extrathreads"]                               = "2";
 	m_default_configuration["extrathreads_height"]                        = "4";
 	m_default_configuration["filter"]                                     = std::to_string(static_cast<int8>(BiFiltering::PS2));
@@ -424,6 +429,9 @@ void GSdxApp::Init()
 	m_default_configuration["shaderfx"]                                   = "0";
 	m_default_configuration["shaderfx_conf"]                              = "shaders/GSdx_FX_Settings.ini";
 	m_default_configuration["shaderfx_glsl"]                              = "shaders/GSdx.fx";
+	m_default_configuration["sw_batch_draws"]                             = "1";
+	m_default_configuration["sw_jit_cache"]                               = "1";
+	m_default_configuration["sw_texture_hash"]                            = "0";
 	m_default_configuration["TVShader"]                                   = "0";
 	m_default_configuration["upscale_multiplier"]                         = "1";
 	m_default_configuration["UserHacks"]                                  = "0";
@@ -515,6 +523,14 @@ void GSdxApp::SetConfigDir(const char* dir)
 	}
 }
 
+// Directory of GSdx.ini, with a trailing separator
+std::string GSdxApp::GetConfigDir()
+{
+	size_t pos = m_ini.find_last_of(DIRECTORY_SEPARATOR);
+
+	return pos != std::string::npos ? m_ini.substr(0, pos + 1) : std::string();
+}
+
 std::string GSdxApp::GetConfigS(const char* entry)
 {
 	char buff[4096] = {0};
@@ -68,6 +68,7 @@ public:
 	GSRendererType GetCurrentRendererType();
 
 	void SetConfigDir(const char* dir);
+	std::string GetConfigDir();
 
 	std::vector<GSSetting> m_gs_renderers;
 	std::vector<GSSetting> m_gs_interlace;
@@ -83,6 +84,7 @@ public:
 	std::vector<GSSetting> m_gs_crc_level;
 	std::vector<GSSetting> m_gs_acc_blend_level;
 	std::vector<GSSetting> m_gs_tv_shaders;
+	std::vector<GSSetting> m_gs_capture_format;
 
 	std::vector<GSSetting> m_gpu_renderers;
 	std::vector<GSSetting> m_gpu_filter;
@@ -0,0 +1,589 @@
+/*
+ *	Copyright (C) 2007-2009 Gabest
+ *	http://www.gabest.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with GNU Make; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+// Standalone benchmark of the GSBlock kernels (make gsblock_bench): each swizzle, unswizzle
+// and clut expand kernel is checked against a plain C version addressing the pixels through
+// the column tables, then both are timed over the same blocks. The kernels are built for the
+// instruction set of the executable, like the plugin (gsblock_bench-SSE4, gsblock_bench-AVX2),
+// the GSBlockAVX512 ones are only run when they are built (ENABLE_AVX512) and the cpu has them.
+//
+// The second part times GSLocalMemory::ReadTexture for every texture format, through the
+// m_psm[psm].rtx the plugin would call (the AVX-512 version when selected at runtime) and
+// through the GSBlock version, and checks that both read the same texture.
+//
+// usage: gsblock_bench [kernel or texture name filter]
+
+#include "stdafx.h"
+#include "GSdx.h"
+#include "GSBlock.h"
+#ifdef ENABLE_AVX512
+#include "GSBlockAVX512.h"
+#endif
+#include "GSLocalMemory.h"
+#include "GSTables.h"
+#include "GSUtil.h"
+#include "GSTextureSW.h"
+#include <chrono>
+
+// Stand-ins for the parts of the plugin GSLocalMemory refers to, the bench only links GSBlock,
+// GSLocalMemory and what they need. The vm is a plain vmalloc (no wrap_gs_mem hack), and
+// SaveBMP is never called.
+
+Xbyak::util::Cpu g_cpu;
+
+GSdxApp theApp;
+
+GSdxApp::GSdxApp() {}
+bool GSdxApp::GetConfigB(const char* entry) {return false;}
+GSRendererType GSdxApp::GetCurrentRendererType() {return GSRendererType::Undefined;}
+
+GSTexture::GSTexture() {}
+GSTextureSW::GSTextureSW(int type, int width, int height) {}
+GSTextureSW::~GSTextureSW() {}
+bool GSTextureSW::Update(const GSVector4i& r, const void* data, int pitch, int layer) {return false;}
+bool GSTextureSW::Map(GSMap& m, const GSVector4i* r, int layer) {return false;}
+void GSTextureSW::Unmap() {}
+bool GSTextureSW::Save(const std::string& fn, bool dds) {return false;}
+
+static const int s_blocks = 1024; // 256 kB of swizzled data, fits in L2 on most cpus
+static const int s_pitch = 128; // linear side, enough for a row of the widest block (32 pixels * 4 bytes)
+static const int s_linear_size = s_pitch * 16;
+
+struct BenchContext
+{
+	const uint32* pal32;
+	const uint64* pal64;
+	GIFRegTEXA TEXA;
+};
+
+typedef void (*BenchKernel)(const uint8* src, uint8* dst, const BenchContext& ctx);
+
+struct BenchEntry
+{
+	const char* name;
+	bool write; // src is linear and dst a block, otherwise the other way around
+	int bytes; // pixel data moved per block, for the GB/s figures
+	BenchKernel fast;
+	BenchKernel ref;
+	bool avx512; // GSBlockAVX512 kernel, needs the cpu check
+};
+
+// helpers of the reference kernels
+
+static __forceinline uint32& Linear32(uint8* p, int x, int y) {return ((uint32*)&p[y * s_pitch])[x];}
+static __forceinline uint16& Linear16(uint8* p, int x, int y) {return ((uint16*)&p[y * s_pitch])[x];}
+static __forceinline uint8& Linear8(uint8* p, int x, int y) {return p[y * s_pitch + x];}
+static __forceinline uint32 Linear32(const uint8* p, int x, int y) {return ((const uint32*)&p[y * s_pitch])[x];}
+static __forceinline uint16 Linear16(const uint8* p, int x, int y) {return ((const uint16*)&p[y * s_pitch])[x];}
+static __forceinline uint8 Linear8(const uint8* p, int x, int y) {return p[y * s_pitch + x];}
+
+static __forceinline uint32 GetNibble(const uint8* p, uint32 i)
+{
+	return (p[i >> 1] >> ((i & 1) << 2)) & 15;
+}
+
+static __forceinline void SetNibble(uint8* p, uint32 i, uint32 v)
+{
+	int shift = (i & 1) << 2;
+
+	p[i >> 1] = (uint8)((p[i >> 1] & ~(15 << shift)) | (v << shift));
+}
+
+static __forceinline uint32 Expand24(uint32 c, const GIFRegTEXA& TEXA, bool AEM)
+{
+	c &= 0x00ffffff;
+
+	return c | (AEM && c == 0 ? 0 : (uint32)TEXA.TA0 << 24);
+}
+
+static __forceinline uint32 Expand16(uint32 c, const GIFRegTEXA& TEXA, bool AEM)
+{
+	uint32 a = c & 0x8000 ? TEXA.TA1 : TEXA.TA0;
+
+	return ((c & 0x001f) << 3) | ((c & 0x03e0) << 6) | ((c & 0x7c00) << 9) | (AEM && c == 0 ? 0 : a << 24);
+}
+
+// swizzle
+
+static void FastWrite32(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::WriteBlock32<32, 0xffffffff>(dst, src, s_pitch);}
+static void FastWrite16(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::WriteBlock16<32>(dst, src, s_pitch);}
+static void FastWrite8(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::WriteBlock8<32>(dst, src, s_pitch);}
+static void FastWrite4(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::WriteBlock4<32>(dst, src, s_pitch);}
+static void FastWrite24(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::UnpackAndWriteBlock24(src, s_pitch, dst);}
+static void FastWrite8H(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::UnpackAndWriteBlock8H(src, s_pitch, dst);}
+static void FastWrite4HL(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::UnpackAndWriteBlock4HL(src, s_pitch, dst);}
+static void FastWrite4HH(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::UnpackAndWriteBlock4HH(src, s_pitch, dst);}
+
+static void RefWrite32(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 8; x++) ((uint32*)dst)[columnTable32[y][x]] = Linear32(src, x, y);
+}
+
+static void RefWrite16(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 16; x++) ((uint16*)dst)[columnTable16[y][x]] = Linear16(src, x, y);
+}
+
+static void RefWrite8(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 16; y++) for(int x = 0; x < 16; x++) dst[columnTable8[y][x]] = Linear8(src, x, y);
+}
+
+static void RefWrite4(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 16; y++) for(int x = 0; x < 32; x++) SetNibble(dst, columnTable4[y][x], GetNibble(&src[y * s_pitch], x));
+}
+
+static void RefWrite24(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++)
+	{
+		for(int x = 0; x < 8; x++)
+		{
+			const uint8* s = &src[y * s_pitch + x * 3];
+			uint32& d = ((uint32*)dst)[columnTable32[y][x]];
+
+			d = (d & 0xff000000) | s[0] | (s[1] << 8) | (s[2] << 16);
+		}
+	}
+}
+
+static void RefWrite8H(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++)
+	{
+		for(int x = 0; x < 8; x++)
+		{
+			uint32& d = ((uint32*)dst)[columnTable32[y][x]];
+
+			d = (d & 0x00ffffff) | ((uint32)Linear8(src, x, y) << 24);
+		}
+	}
+}
+
+static void RefWrite4HL(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++)
+	{
+		for(int x = 0; x < 8; x++)
+		{
+			uint32& d = ((uint32*)dst)[columnTable32[y][x]];
+
+			d = (d & 0xf0ffffff) | (GetNibble(&src[y * s_pitch], x) << 24);
+		}
+	}
+}
+
+static void RefWrite4HH(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++)
+	{
+		for(int x = 0; x < 8; x++)
+		{
+			uint32& d = ((uint32*)dst)[columnTable32[y][x]];
+
+			d = (d & 0x0fffffff) | (GetNibble(&src[y * s_pitch], x) << 28);
+		}
+	}
+}
+
+// unswizzle
+
+static void FastRead32(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadBlock32(src, dst, s_pitch);}
+static void FastRead16(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadBlock16(src, dst, s_pitch);}
+static void FastRead8(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadBlock8(src, dst, s_pitch);}
+static void FastRead4(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadBlock4(src, dst, s_pitch);}
+static void FastRead4P(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadBlock4P(src, dst, s_pitch);}
+static void FastRead8HP(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadBlock8HP(src, dst, s_pitch);}
+static void FastRead4HLP(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadBlock4HLP(src, dst, s_pitch);}
+static void FastRead4HHP(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadBlock4HHP(src, dst, s_pitch);}
+
+static void RefRead32(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 8; x++) Linear32(dst, x, y) = ((const uint32*)src)[columnTable32[y][x]];
+}
+
+static void RefRead16(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 16; x++) Linear16(dst, x, y) = ((const uint16*)src)[columnTable16[y][x]];
+}
+
+static void RefRead8(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 16; y++) for(int x = 0; x < 16; x++) Linear8(dst, x, y) = src[columnTable8[y][x]];
+}
+
+static void RefRead4(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 16; y++) for(int x = 0; x < 32; x++) SetNibble(&dst[y * s_pitch], x, GetNibble(src, columnTable4[y][x]));
+}
+
+static void RefRead4P(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 16; y++) for(int x = 0; x < 32; x++) Linear8(dst, x, y) = (uint8)GetNibble(src, columnTable4[y][x]);
+}
+
+static void RefRead8HP(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 8; x++) Linear8(dst, x, y) = (uint8)(((const uint32*)src)[columnTable32[y][x]] >> 24);
+}
+
+static void RefRead4HLP(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 8; x++) Linear8(dst, x, y) = (uint8)((((const uint32*)src)[columnTable32[y][x]] >> 24) & 15);
+}
+
+static void RefRead4HHP(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 8; x++) Linear8(dst, x, y) = (uint8)(((const uint32*)src)[columnTable32[y][x]] >> 28);
+}
+
+// unswizzle and expand to 32 bits
+
+static void FastExpand24(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadAndExpandBlock24<false>(src, dst, s_pitch, ctx.TEXA);}
+static void FastExpand24AEM(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadAndExpandBlock24<true>(src, dst, s_pitch, ctx.TEXA);}
+static void FastExpand16(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadAndExpandBlock16<false>(src, dst, s_pitch, ctx.TEXA);}
+static void FastExpand16AEM(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadAndExpandBlock16<true>(src, dst, s_pitch, ctx.TEXA);}
+static void FastExpand8(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadAndExpandBlock8_32(src, dst, s_pitch, ctx.pal32);}
+static void FastExpand4(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadAndExpandBlock4_32(src, dst, s_pitch, ctx.pal64);}
+static void FastExpand8H(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadAndExpandBlock8H_32(src, dst, s_pitch, ctx.pal32);}
+static void FastExpand4HL(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadAndExpandBlock4HL_32(src, dst, s_pitch, ctx.pal32);}
+static void FastExpand4HH(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlock::ReadAndExpandBlock4HH_32(src, dst, s_pitch, ctx.pal32);}
+
+#ifdef ENABLE_AVX512
+static void FastRead32AVX512(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlockAVX512::ReadBlock32(src, dst, s_pitch);}
+static void FastRead16AVX512(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlockAVX512::ReadBlock16(src, dst, s_pitch);}
+static void FastExpand24AVX512(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlockAVX512::ReadAndExpandBlock24(src, dst, s_pitch, ctx.TEXA.TA0, false);}
+static void FastExpand24AEMAVX512(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlockAVX512::ReadAndExpandBlock24(src, dst, s_pitch, ctx.TEXA.TA0, true);}
+static void FastExpand16AVX512(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlockAVX512::ReadAndExpandBlock16(src, dst, s_pitch, ctx.TEXA.TA0, ctx.TEXA.TA1, false);}
+static void FastExpand16AEMAVX512(const uint8* src, uint8* dst, const BenchContext& ctx) {GSBlockAVX512::ReadAndExpandBlock16(src, dst, s_pitch, ctx.TEXA.TA0, ctx.TEXA.TA1, true);}
+#endif
+
+static void RefExpand24(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 8; x++) Linear32(dst, x, y) = Expand24(((const uint32*)src)[columnTable32[y][x]], ctx.TEXA, false);
+}
+
+static void RefExpand24AEM(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 8; x++) Linear32(dst, x, y) = Expand24(((const uint32*)src)[columnTable32[y][x]], ctx.TEXA, true);
+}
+
+static void RefExpand16(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 16; x++) Linear32(dst, x, y) = Expand16(((const uint16*)src)[columnTable16[y][x]], ctx.TEXA, false);
+}
+
+static void RefExpand16AEM(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 16; x++) Linear32(dst, x, y) = Expand16(((const uint16*)src)[columnTable16[y][x]], ctx.TEXA, true);
+}
+
+static void RefExpand8(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 16; y++) for(int x = 0; x < 16; x++) Linear32(dst, x, y) = ctx.pal32[src[columnTable8[y][x]]];
+}
+
+static void RefExpand4(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 16; y++) for(int x = 0; x < 32; x++) Linear32(dst, x, y) = ctx.pal32[GetNibble(src, columnTable4[y][x])];
+}
+
+static void RefExpand8H(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 8; x++) Linear32(dst, x, y) = ctx.pal32[((const uint32*)src)[columnTable32[y][x]] >> 24];
+}
+
+static void RefExpand4HL(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 8; x++) Linear32(dst, x, y) = ctx.pal32[(((const uint32*)src)[columnTable32[y][x]] >> 24) & 15];
+}
+
+static void RefExpand4HH(const uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	for(int y = 0; y < 8; y++) for(int x = 0; x < 8; x++) Linear32(dst, x, y) = ctx.pal32[((const uint32*)src)[columnTable32[y][x]] >> 28];
+}
+
+static const BenchEntry s_entries[] =
+{
+	{"write32", true, 256, FastWrite32, RefWrite32},
+	{"write24", true, 192, FastWrite24, RefWrite24},
+	{"write16", true, 256, FastWrite16, RefWrite16},
+	{"write8", true, 256, FastWrite8, RefWrite8},
+	{"write4", true, 256, FastWrite4, RefWrite4},
+	{"write8H", true, 64, FastWrite8H, RefWrite8H},
+	{"write4HL", true, 32, FastWrite4HL, RefWrite4HL},
+	{"write4HH", true, 32, FastWrite4HH, RefWrite4HH},
+	{"read32", false, 256, FastRead32, RefRead32},
+	{"read16", false, 256, FastRead16, RefRead16},
+	{"read8", false, 256, FastRead8, RefRead8},
+	{"read4", false, 256, FastRead4, RefRead4},
+	{"read4P", false, 512, FastRead4P, RefRead4P},
+	{"read8HP", false, 64, FastRead8HP, RefRead8HP},
+	{"read4HLP", false, 64, FastRead4HLP, RefRead4HLP},
+	{"read4HHP", false, 64, FastRead4HHP, RefRead4HHP},
+	{"expand24", false, 256, FastExpand24, RefExpand24},
+	{"expand24aem", false, 256, FastExpand24AEM, RefExpand24AEM},
+	{"expand16", false, 512, FastExpand16, RefExpand16},
+	{"expand16aem", false, 512, FastExpand16AEM, RefExpand16AEM},
+	{"expand8", false, 1024, FastExpand8, RefExpand8},
+	{"expand4", false, 2048, FastExpand4, RefExpand4},
+	{"expand8H", false, 256, FastExpand8H, RefExpand8H},
+	{"expand4HL", false, 256, FastExpand4HL, RefExpand4HL},
+	{"expand4HH", false, 256, FastExpand4HH, RefExpand4HH},
+#ifdef ENABLE_AVX512
+	{"read32-avx512", false, 256, FastRead32AVX512, RefRead32, true},
+	{"read16-avx512", false, 256, FastRead16AVX512, RefRead16, true},
+	{"expand24-avx512", false, 256, FastExpand24AVX512, RefExpand24, true},
+	{"expand24aem-avx512", false, 256, FastExpand24AEMAVX512, RefExpand24AEM, true},
+	{"expand16-avx512", false, 512, FastExpand16AVX512, RefExpand16, true},
+	{"expand16aem-avx512", false, 512, FastExpand16AEMAVX512, RefExpand16AEM, true},
+#endif
+};
+
+struct TextureBenchEntry
+{
+	const char* name;
+	uint32 psm;
+	GSLocalMemory::readTexture base; // GSBlock version, m_psm[psm].rtx may differ
+};
+
+static const TextureBenchEntry s_textures[] =
+{
+	{"tex32", PSM_PSMCT32, &GSLocalMemory::ReadTexture32},
+	{"tex24", PSM_PSMCT24, &GSLocalMemory::ReadTexture24},
+	{"tex16", PSM_PSMCT16, &GSLocalMemory::ReadTexture16},
+	{"tex16S", PSM_PSMCT16S, &GSLocalMemory::ReadTexture16},
+	{"tex8", PSM_PSMT8, &GSLocalMemory::ReadTexture8},
+	{"tex4", PSM_PSMT4, &GSLocalMemory::ReadTexture4},
+	{"tex8H", PSM_PSMT8H, &GSLocalMemory::ReadTexture8H},
+	{"tex4HL", PSM_PSMT4HL, &GSLocalMemory::ReadTexture4HL},
+	{"tex4HH", PSM_PSMT4HH, &GSLocalMemory::ReadTexture4HH},
+	{"texZ32", PSM_PSMZ32, &GSLocalMemory::ReadTexture32},
+	{"texZ24", PSM_PSMZ24, &GSLocalMemory::ReadTexture24},
+	{"texZ16", PSM_PSMZ16, &GSLocalMemory::ReadTexture16},
+};
+
+static const int s_tex_size = 512; // 1 MB of 32 bits texels, the biggest texture fits in the 4 MB of vm
+
+// Runs the kernel over every block, returns the best time of a pass in seconds
+
+static double Run(BenchKernel kernel, bool write, uint8* src, uint8* dst, const BenchContext& ctx)
+{
+	int src_size = write ? s_linear_size : 256;
+	int dst_size = write ? 256 : s_linear_size;
+
+	double best = 1e9;
+	double total = 0;
+
+	for(int pass = 0; pass < 1000 && (pass < 5 || total < 0.2); pass++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		for(int i = 0; i < s_blocks; i++)
+		{
+			kernel(&src[i * src_size], &dst[i * dst_size], ctx);
+		}
+
+		double t = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		best = std::min(best, t);
+		total += t;
+	}
+
+	return best;
+}
+
+// Same for a whole texture, readTexture is a member of mem
+
+static double RunTexture(GSLocalMemory& mem, GSLocalMemory::readTexture rtx, const GSOffset* off, uint8* dst, const GIFRegTEXA& TEXA)
+{
+	GSVector4i r(0, 0, s_tex_size, s_tex_size);
+
+	double best = 1e9;
+	double total = 0;
+
+	for(int pass = 0; pass < 1000 && (pass < 5 || total < 0.2); pass++)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+
+		(mem.*rtx)(off, r, dst, s_tex_size * 4, TEXA);
+
+		double t = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+		best = std::min(best, t);
+		total += t;
+	}
+
+	return best;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* filter = argc > 1 ? argv[1] : NULL;
+
+	GSVector4i::InitVectors();
+	GSVector4::InitVectors();
+#if _M_SSE >= 0x500
+	GSVector8::InitVectors();
+#endif
+#if _M_SSE >= 0x501
+	GSVector8i::InitVectors();
+#endif
+	GSBlock::InitVectors();
+
+	size_t size = s_blocks * s_linear_size;
+
+	uint8* src = (uint8*)_aligned_malloc(size, 64);
+	uint8* dst_init = (uint8*)_aligned_malloc(size, 64);
+	uint8* dst_fast = (uint8*)_aligned_malloc(size, 64);
+	uint8* dst_ref = (uint8*)_aligned_malloc(size, 64);
+
+	uint32* pal32 = (uint32*)_aligned_malloc(256 * sizeof(uint32), 64);
+	uint64* pal64 = (uint64*)_aligned_malloc(256 * sizeof(uint64), 64);
+
+	uint32 seed = 0x12345678;
+
+	auto rnd = [&seed]() -> uint32 {seed = seed * 1664525 + 1013904223; return seed >> 8;};
+
+	for(size_t i = 0; i < size; i++)
+	{
+		// some zero pixels for the AEM paths
+
+		src[i] = (i & 0x3ff) < 0x40 ? 0 : (uint8)rnd();
+		dst_init[i] = (uint8)rnd();
+	}
+
+	for(int i = 0; i < 256; i++)
+	{
+		pal32[i] = rnd() ^ (rnd() << 24);
+	}
+
+	for(int i = 0; i < 256; i++)
+	{
+		pal64[i] = ((uint64)pal32[i >> 4] << 32) | pal32[i & 15]; // two 4-bit pixels of a byte at once, see GSClut
+	}
+
+	BenchContext ctx;
+
+	ctx.pal32 = pal32;
+	ctx.pal64 = pal64;
+	ctx.TEXA.u64 = 0;
+	ctx.TEXA.TA0 = 0x40;
+	ctx.TEXA.TA1 = 0x80;
+
+#ifdef ENABLE_AVX512
+	bool avx512 = g_cpu.has(Xbyak::util::Cpu::tAVX512F) && g_cpu.has(Xbyak::util::Cpu::tAVX512BW);
+#else
+	bool avx512 = false; // not built, the compiler doesn't have the flags
+#endif
+
+	printf("GSBlock kernels, _M_SSE %x, AVX-512 %s, %d blocks\n", _M_SSE, avx512 ? "yes" : "no", s_blocks);
+	printf("%-18s %6s %10s %10s %8s\n", "kernel", "check", "GB/s", "ref GB/s", "speedup");
+
+	int failed = 0;
+
+	for(size_t i = 0; i < countof(s_entries); i++)
+	{
+		const BenchEntry& e = s_entries[i];
+
+		if((filter != NULL && strstr(e.name, filter) == NULL) || (e.avx512 && !avx512))
+		{
+			continue;
+		}
+
+		memcpy(dst_fast, dst_init, size);
+		memcpy(dst_ref, dst_init, size);
+
+		double t_fast = Run(e.fast, e.write, src, dst_fast, ctx);
+		double t_ref = Run(e.ref, e.write, src, dst_ref, ctx);
+
+		// every pass writes the same output, and the partial writes (24, 8H, 4HL, 4HH) keep the rest of dst_init
+
+		bool ok = memcmp(dst_fast, dst_ref, size) == 0;
+
+		if(!ok)
+		{
+			failed++;
+		}
+
+		double bytes = (double)e.bytes * s_blocks;
+
+		printf("%-18s %6s %10.2f %10.2f %7.1fx\n", e.name, ok ? "ok" : "FAILED", bytes / t_fast / 1e9, bytes / t_ref / 1e9, t_ref / t_fast);
+	}
+
+	// GSLocalMemory::ReadTexture, the vm is random like the blocks above, the clut is whatever GSClut starts with
+
+	GSLocalMemory* mem = new GSLocalMemory();
+
+	for(int i = 0; i < GSLocalMemory::m_vmsize; i++)
+	{
+		mem->m_vm8[i] = (uint8)rnd();
+	}
+
+	uint8* tex_fast = (uint8*)_aligned_malloc(s_tex_size * s_tex_size * 4, 64);
+	uint8* tex_base = (uint8*)_aligned_malloc(s_tex_size * s_tex_size * 4, 64);
+
+	printf("\nGSLocalMemory::ReadTexture, %dx%d\n", s_tex_size, s_tex_size);
+	printf("%-18s %6s %10s %10s %8s\n", "texture", "check", "GB/s", "base GB/s", "speedup");
+
+	for(size_t i = 0; i < countof(s_textures); i++)
+	{
+		const TextureBenchEntry& e = s_textures[i];
+
+		if(filter != NULL && strstr(e.name, filter) == NULL)
+		{
+			continue;
+		}
+
+		const GSOffset* off = mem->GetOffset(0, s_tex_size / 64, e.psm);
+
+		GSLocalMemory::readTexture rtx = GSLocalMemory::m_psm[e.psm].rtx;
+
+		double t_fast = RunTexture(*mem, rtx, off, tex_fast, ctx.TEXA);
+		double t_base = rtx != e.base ? RunTexture(*mem, e.base, off, tex_base, ctx.TEXA) : t_fast;
+
+		bool ok = rtx == e.base || memcmp(tex_fast, tex_base, s_tex_size * s_tex_size * 4) == 0;
+
+		if(!ok)
+		{
+			failed++;
+		}
+
+		double bytes = (double)s_tex_size * s_tex_size * 4;
+
+		printf("%-18s %6s %10.2f %10.2f %7.1fx\n", e.name, ok ? "ok" : "FAILED", bytes / t_fast / 1e9, bytes / t_base / 1e9, t_base / t_fast);
+	}
+
+	_aligned_free(tex_fast);
+	_aligned_free(tex_base);
+
+	delete mem;
+
+	_aligned_free(src);
+	_aligned_free(dst_init);
+	_aligned_free(dst_fast);
+	_aligned_free(dst_ref);
+	_aligned_free(pal32);
+	_aligned_free(pal64);
+
+	return failed ? 1 : 0;
+}
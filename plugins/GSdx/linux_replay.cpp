@@ -21,6 +21,7 @@
 #include <dlfcn.h>
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 static void* handle;
@@ -31,6 +32,14 @@ void help()
 	fprintf(stderr, "ARG1 GSdx plugin\n");
 	fprintf(stderr, "ARG2 .gs file\n");
 	fprintf(stderr, "ARG3 Ini directory\n");
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Options (must come first)\n");
+	fprintf(stderr, "--frame N        start the replay at frame N (fast with keyframed .gsk dumps)\n");
+	fprintf(stderr, "\n");
+	fprintf(stderr, "Headless benchmark options (must come first)\n");
+	fprintf(stderr, "--bench N        replay the dump N times without a window and print frame timings\n");
+	fprintf(stderr, "--renderer R     sw (default) or null\n");
+	fprintf(stderr, "--json FILE      also write the benchmark summary as JSON\n");
 	if (handle) {
 		dlclose(handle);
 	}
@@ -48,7 +57,41 @@ char* read_env(const char* var) {
 
 int main ( int argc, char *argv[] )
 {
-	if (argc < 1) help();
+	int bench_loops = 0;
+	int bench_renderer = 13; // GSRendererType::OGL_SW
+	const char* bench_json = nullptr;
+	int start_frame = 0;
+
+	// Strip the benchmark options so the positional arguments keep their meaning
+	while (argc > 2 && strncmp(argv[1], "--", 2) == 0) {
+		std::string opt(argv[1]);
+
+		if (opt == "--bench") {
+			bench_loops = atoi(argv[2]);
+			if (bench_loops <= 0) help();
+		} else if (opt == "--renderer") {
+			std::string r(argv[2]);
+			if (r == "sw")
+				bench_renderer = 13; // GSRendererType::OGL_SW
+			else if (r == "null")
+				bench_renderer = 11; // GSRendererType::Null
+			else
+				help();
+		} else if (opt == "--json") {
+			bench_json = argv[2];
+		} else if (opt == "--frame") {
+			start_frame = atoi(argv[2]);
+			if (start_frame < 0) help();
+		} else {
+			help();
+		}
+
+		argv[2] = argv[0];
+		argv += 2;
+		argc -= 2;
+	}
+
+	if (argc < 2) help();
 
 	char* plugin;
 	char* gs;
@@ -68,9 +111,13 @@ int main ( int argc, char *argv[] )
 
 	__attribute__((stdcall)) void (*GSsetSettingsDir_ptr)(const char*);
 	__attribute__((stdcall)) void (*GSReplay_ptr)(char*, int);
+	__attribute__((stdcall)) void (*GSBenchmarkReplay_ptr)(char*, int, int, const char*);
+	__attribute__((stdcall)) void (*GSReplayStartFrame_ptr)(int);
 
 	GSsetSettingsDir_ptr = reinterpret_cast<decltype(GSsetSettingsDir_ptr)>(dlsym(handle, "GSsetSettingsDir"));
 	GSReplay_ptr = reinterpret_cast<decltype(GSReplay_ptr)>(dlsym(handle, "GSReplay"));
+	GSBenchmarkReplay_ptr = reinterpret_cast<decltype(GSBenchmarkReplay_ptr)>(dlsym(handle, "GSBenchmarkReplay"));
+	GSReplayStartFrame_ptr = reinterpret_cast<decltype(GSReplayStartFrame_ptr)>(dlsym(handle, "GSReplayStartFrame"));
 
 	if (argc == 2) {
 		char *ini = read_env("GSDUMP_CONF");
@@ -94,7 +141,25 @@ int main ( int argc, char *argv[] )
 #endif
 	}
 
-	GSReplay_ptr(gs, 12);
+	if (bench_loops > 0) {
+		if (GSBenchmarkReplay_ptr == NULL) {
+			fprintf(stderr, "Plugin %s doesn't support the benchmark mode\n", plugin);
+			help();
+		}
+
+		GSBenchmarkReplay_ptr(gs, bench_renderer, bench_loops, bench_json);
+	} else {
+		if (start_frame > 0) {
+			if (GSReplayStartFrame_ptr == NULL) {
+				fprintf(stderr, "Plugin %s doesn't support --frame\n", plugin);
+				help();
+			}
+
+			GSReplayStartFrame_ptr(start_frame);
+		}
+
+		GSReplay_ptr(gs, 12);
+	}
 
 	if (handle) {
 		dlclose(handle);
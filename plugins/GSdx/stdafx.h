@@ -109,6 +109,7 @@ typedef int64 sint64;
 #include <array>
 #include <vector>
 #include <list>
+#include <deque>
 #include <map>
 #include <set>
 #include <queue>
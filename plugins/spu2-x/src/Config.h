@@ -82,6 +82,7 @@ extern int dplLevel;
 extern u32 OutputModule;
 extern int SndOutLatencyMS;
 extern int SynchMode;
+extern bool OutputThread;
 
 #ifndef __POSIX__
 extern wchar_t dspPlugin[];
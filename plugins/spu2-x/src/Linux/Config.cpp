@@ -75,6 +75,7 @@ bool _visual_debug_enabled = false; // windows only feature
 u32 OutputModule = 0;
 int SndOutLatencyMS = 300;
 int SynchMode = 0; // Time Stretch, Async or Disabled
+bool OutputThread = false;
 static u32 OutputAPI = 0;
 static u32 SdlOutputAPI = 0;
 
@@ -154,6 +155,7 @@ void ReadSettings()
 
     SndOutLatencyMS = CfgReadInt(L"OUTPUT", L"Latency", 300);
     SynchMode = CfgReadInt(L"OUTPUT", L"Synch_Mode", 0);
+    OutputThread = CfgReadBool(L"OUTPUT", L"Output_Thread", false);
 
     PortaudioOut->ReadSettings();
 #ifdef __unix__
@@ -198,6 +200,7 @@ void WriteSettings()
     CfgWriteStr(L"OUTPUT", L"Output_Module", mods[OutputModule]->GetIdent());
     CfgWriteInt(L"OUTPUT", L"Latency", SndOutLatencyMS);
     CfgWriteInt(L"OUTPUT", L"Synch_Mode", SynchMode);
+    CfgWriteBool(L"OUTPUT", L"Output_Thread", OutputThread);
     CfgWriteInt(L"DEBUG", L"DelayCycles", delayCycles);
 
     PortaudioOut->WriteSettings();
@@ -241,6 +244,7 @@ void DisplayDialog()
 #endif
     GtkWidget *latency_label, *latency_slide;
     GtkWidget *sync_label, *sync_box;
+    GtkWidget *thread_check;
     GtkWidget *advanced_button;
 
     /* Create the widgets */
@@ -312,6 +316,8 @@ void DisplayDialog()
     gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(sync_box), "None (Audio can skip.)");
     gtk_combo_box_set_active(GTK_COMBO_BOX(sync_box), SynchMode);
 
+    thread_check = gtk_check_button_new_with_label("Process the output on a separate thread");
+
     advanced_button = gtk_button_new_with_label("Advanced...");
 
     main_box = gtk_hbox_new(false, 5);
@@ -343,6 +349,7 @@ void DisplayDialog()
 #endif
     gtk_container_add(GTK_CONTAINER(output_box), sync_label);
     gtk_container_add(GTK_CONTAINER(output_box), sync_box);
+    gtk_container_add(GTK_CONTAINER(output_box), thread_check);
     gtk_container_add(GTK_CONTAINER(output_box), latency_label);
     gtk_container_add(GTK_CONTAINER(output_box), latency_slide);
     gtk_container_add(GTK_CONTAINER(output_box), advanced_button);
@@ -352,6 +359,7 @@ void DisplayDialog()
 
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(effects_check), EffectsDisabled);
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(dealias_filter), postprocess_filter_dealias);
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(thread_check), OutputThread);
     //FinalVolume;
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(debug_check), DebugEnabled);
 
@@ -414,6 +422,8 @@ void DisplayDialog()
 
         if (gtk_combo_box_get_active(GTK_COMBO_BOX(sync_box)) != -1)
             SynchMode = gtk_combo_box_get_active(GTK_COMBO_BOX(sync_box));
+
+        OutputThread = gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(thread_check));
     }
 
     gtk_widget_destroy(dialog);
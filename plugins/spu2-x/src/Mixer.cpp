@@ -16,6 +16,7 @@
  */
 
 #include "Global.h"
+#include "MixerVoices.h"
 
 // Games have turned out to be surprisingly sensitive to whether a parked, silent voice is being fully emulated.
 // With Silent Hill: Shattered Memories requiring full processing for no obvious reason, we've decided to
@@ -339,82 +340,12 @@ static __forceinline void CalculateADSR(V_Core &thiscore, uint voiceidx)
     pxAssume(vc.ADSR.Value >= 0); // ADSR should never be negative...
 }
 
-/*
-   Tension: 65535 is high, 32768 is normal, 0 is low
-*/
-template <s32 i_tension>
-__forceinline static s32 HermiteInterpolate(
-    s32 y0, // 16.0
-    s32 y1, // 16.0
-    s32 y2, // 16.0
-    s32 y3, // 16.0
-    s32 mu  //  0.12
-    )
-{
-    s32 m00 = ((y1 - y0) * i_tension) >> 16; // 16.0
-    s32 m01 = ((y2 - y1) * i_tension) >> 16; // 16.0
-    s32 m0 = m00 + m01;
-
-    s32 m10 = ((y2 - y1) * i_tension) >> 16; // 16.0
-    s32 m11 = ((y3 - y2) * i_tension) >> 16; // 16.0
-    s32 m1 = m10 + m11;
-
-    s32 val = ((2 * y1 + m0 + m1 - 2 * y2) * mu) >> 12;       // 16.0
-    val = ((val - 3 * y1 - 2 * m0 - m1 + 3 * y2) * mu) >> 12; // 16.0
-    val = ((val + m0) * mu) >> 11;                            // 16.0
-
-    return (val + (y1 << 1));
-}
-
-__forceinline static s32 CatmullRomInterpolate(
-    s32 y0, // 16.0
-    s32 y1, // 16.0
-    s32 y2, // 16.0
-    s32 y3, // 16.0
-    s32 mu  //  0.12
-    )
-{
-    //q(t) = 0.5 *(    	(2 * P1) +
-    //	(-P0 + P2) * t +
-    //	(2*P0 - 5*P1 + 4*P2 - P3) * t2 +
-    //	(-P0 + 3*P1- 3*P2 + P3) * t3)
-
-    s32 a3 = (-y0 + 3 * y1 - 3 * y2 + y3);
-    s32 a2 = (2 * y0 - 5 * y1 + 4 * y2 - y3);
-    s32 a1 = (-y0 + y2);
-    s32 a0 = (2 * y1);
-
-    s32 val = ((a3)*mu) >> 12;
-    val = ((a2 + val) * mu) >> 12;
-    val = ((a1 + val) * mu) >> 12;
-
-    return (a0 + val);
-}
-
-__forceinline static s32 CubicInterpolate(
-    s32 y0, // 16.0
-    s32 y1, // 16.0
-    s32 y2, // 16.0
-    s32 y3, // 16.0
-    s32 mu  //  0.12
-    )
-{
-    const s32 a0 = y3 - y2 - y0 + y1;
-    const s32 a1 = y0 - y1 - a0;
-    const s32 a2 = y2 - y0;
-
-    s32 val = ((a0)*mu) >> 12;
-    val = ((val + a1) * mu) >> 12;
-    val = ((val + a2) * mu) >> 11;
-
-    return (val + (y1 << 1));
-}
-
-// Returns a 16 bit result in Value.
+// Fetches the samples needed to interpolate the voice's current position (PV1, and PV2 to
+// PV4 depending on the interpolation), the interpolation itself is done by MixVoiceLanes.
 // Uses standard template-style optimization techniques to statically generate five different
 // versions of this function (one for each type of interpolation).
 template <int InterpType>
-static __forceinline s32 GetVoiceValues(V_Core &thiscore, uint voiceidx)
+static __forceinline void GetVoiceValues(V_Core &thiscore, uint voiceidx)
 {
     V_Voice &vc(thiscore.Voices[voiceidx]);
 
@@ -427,26 +358,6 @@ static __forceinline s32 GetVoiceValues(V_Core &thiscore, uint voiceidx)
         vc.PV1 = GetNextDataBuffered(thiscore, voiceidx);
         vc.SP -= 4096;
     }
-
-    const s32 mu = vc.SP + 4096;
-
-    switch (InterpType) {
-        case 0:
-            return vc.PV1 << 1;
-        case 1:
-            return (vc.PV1 << 1) - (((vc.PV2 - vc.PV1) * vc.SP) >> 11);
-
-        case 2:
-            return CubicInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-        case 3:
-            return HermiteInterpolate<16384>(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-        case 4:
-            return CatmullRomInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, mu);
-
-            jNO_DEFAULT;
-    }
-
-    return 0; // technically unreachable!
 }
 
 // Noise values need to be mixed without going through interpolation, since it
@@ -495,7 +406,11 @@ static __forceinline void spu2M_WriteFast(u32 addr, s16 value)
 }
 
 
-static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
+// Everything of the voice but its output value: pitch, sample fetching, envelope and the
+// modulation/write-back data, which the next voices depend on.  What's needed to compute
+// the output goes to the voice's lane, see MixerVoices.h.
+template <int InterpType>
+static __forceinline void MixVoice(uint coreidx, uint voiceidx, VoiceLanes &lanes)
 {
     V_Core &thiscore(Cores[coreidx]);
     V_Voice &vc(thiscore.Voices[voiceidx]);
@@ -510,6 +425,9 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 
     vc.Volume.Update();
 
+    lanes.VolL[voiceidx] = vc.Volume.Left.Value;
+    lanes.VolR[voiceidx] = vc.Volume.Right.Value;
+
     // SPU2 Note: The spu2 continues to process voices for eternity, always, so we
     // have to run through all the motions of updating the voice regardless of it's
     // audible status.  Otherwise IRQs might not trigger and emulation might fail.
@@ -517,35 +435,20 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
     if (vc.ADSR.Phase > 0) {
         UpdatePitch(coreidx, voiceidx);
 
-        s32 Value = 0;
-
-        if (vc.Noise)
-            Value = GetNoiseValues(thiscore, voiceidx);
-        else {
-            // Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
-            // turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
-
-            switch (Interpolation) {
-                case 0:
-                    Value = GetVoiceValues<0>(thiscore, voiceidx);
-                    break;
-                case 1:
-                    Value = GetVoiceValues<1>(thiscore, voiceidx);
-                    break;
-                case 2:
-                    Value = GetVoiceValues<2>(thiscore, voiceidx);
-                    break;
-                case 3:
-                    Value = GetVoiceValues<3>(thiscore, voiceidx);
-                    break;
-                case 4:
-                    Value = GetVoiceValues<4>(thiscore, voiceidx);
-                    break;
-
-                    jNO_DEFAULT;
-            }
+        if (vc.Noise) {
+            lanes.Raw[voiceidx] = GetNoiseValues(thiscore, voiceidx);
+            lanes.IsRaw[voiceidx] = -1;
+        } else {
+            GetVoiceValues<InterpType>(thiscore, voiceidx);
+            lanes.IsRaw[voiceidx] = 0;
         }
 
+        lanes.PV1[voiceidx] = vc.PV1;
+        lanes.PV2[voiceidx] = vc.PV2;
+        lanes.PV3[voiceidx] = vc.PV3;
+        lanes.PV4[voiceidx] = vc.PV4;
+        lanes.SP[voiceidx] = vc.SP;
+
         // Update and Apply ADSR  (applies to normal and noise sources)
         //
         // Note!  It's very important that ADSR stay as accurate as possible.  By the way
@@ -554,7 +457,7 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
         // use a full 64-bit multiply/result here.
 
         CalculateADSR(thiscore, voiceidx);
-        Value = MulShr32(Value, vc.ADSR.Value);
+        lanes.ADSR[voiceidx] = vc.ADSR.Value;
 
         // Store Value for eventual modulation later
         // Pseudonym's Crest calculation idea. Actually calculates a crest, unlike the old code which was just peak.
@@ -575,8 +478,6 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
             spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, vc.OutX);
         else if (voiceidx == 3)
             spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, vc.OutX);
-
-        return ApplyVolume(StereoOut32(Value, Value), vc.Volume);
     } else {
         // Continue processing voice, even if it's "off". Or else we miss interrupts! (Fatal Frame engine died because of this.)
         if (NEVER_SKIP_VOICES || (*GetMemPtr(vc.NextA & 0xFFFF8) >> 8 & 3) != 3 || vc.LoopStartA != (vc.NextA & ~7)    // not in a tight loop
@@ -595,25 +496,85 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
         else if (voiceidx == 3)
             spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, 0);
 
-        return StereoOut32(0, 0);
+        // Silent, whatever the lane interpolates to
+        lanes.PV1[voiceidx] = lanes.PV2[voiceidx] = lanes.PV3[voiceidx] = lanes.PV4[voiceidx] = 0;
+        lanes.SP[voiceidx] = 0;
+        lanes.IsRaw[voiceidx] = 0;
+        lanes.ADSR[voiceidx] = 0;
     }
 }
 
 const VoiceMixSet VoiceMixSet::Empty((StereoOut32()), (StereoOut32())); // Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
 
+static_assert(VoiceLanes::Count == V_Core::NumVoices, "VoiceLanes needs a lane per voice");
+
+static MixVoiceLanesFn *const MixVoiceLanes_Plain[5] =
+{
+    MixVoiceLanes_Scalar<0>,
+    MixVoiceLanes_Scalar<1>,
+    MixVoiceLanes_Scalar<2>,
+    MixVoiceLanes_Scalar<3>,
+    MixVoiceLanes_Scalar<4>,
+};
+
+// Picked once, the widest version the cpu runs (see MixerVoices.h)
+static MixVoiceLanesFn *const *const MixVoiceLanes =
+    MixVoiceLanesHasAVX2() ? MixVoiceLanes_AVX2 :
+    MixVoiceLanesHasSSE41() ? MixVoiceLanes_SSE41 :
+    MixVoiceLanes_Plain;
+
+template <int InterpType>
 static __forceinline void MixCoreVoices(VoiceMixSet &dest, const uint coreidx)
 {
     V_Core &thiscore(Cores[coreidx]);
 
+    static VoiceLanes lanes;
+
+    // The voices must be processed in order (pitch modulation uses the previous voice's
+    // output), but mixing them can be done all at once.
+
     for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx) {
-        StereoOut32 VVal(MixVoice(coreidx, voiceidx));
+        MixVoice<InterpType>(coreidx, voiceidx, lanes);
+
+        lanes.DryL[voiceidx] = thiscore.VoiceGates[voiceidx].DryL;
+        lanes.DryR[voiceidx] = thiscore.VoiceGates[voiceidx].DryR;
+        lanes.WetL[voiceidx] = thiscore.VoiceGates[voiceidx].WetL;
+        lanes.WetR[voiceidx] = thiscore.VoiceGates[voiceidx].WetR;
+    }
 
-        // Note: Results from MixVoice are ranged at 16 bits.
+    // Note: Results of the voices are ranged at 16 bits.
 
-        dest.Dry.Left += VVal.Left & thiscore.VoiceGates[voiceidx].DryL;
-        dest.Dry.Right += VVal.Right & thiscore.VoiceGates[voiceidx].DryR;
-        dest.Wet.Left += VVal.Left & thiscore.VoiceGates[voiceidx].WetL;
-        dest.Wet.Right += VVal.Right & thiscore.VoiceGates[voiceidx].WetR;
+    VoiceLaneSums sums = {dest.Dry.Left, dest.Dry.Right, dest.Wet.Left, dest.Wet.Right};
+
+    MixVoiceLanes[InterpType](lanes, sums);
+
+    dest.Dry = StereoOut32(sums.DryL, sums.DryR);
+    dest.Wet = StereoOut32(sums.WetL, sums.WetR);
+}
+
+static __forceinline void MixCoreVoices(VoiceMixSet &dest, const uint coreidx)
+{
+    // Optimization : Forceinline'd Templated Dispatch Table.  Any halfwit compiler will
+    // turn this into a clever jump dispatch table (no call/rets, no compares, uber-efficient!)
+
+    switch (Interpolation) {
+        case 0:
+            MixCoreVoices<0>(dest, coreidx);
+            break;
+        case 1:
+            MixCoreVoices<1>(dest, coreidx);
+            break;
+        case 2:
+            MixCoreVoices<2>(dest, coreidx);
+            break;
+        case 3:
+            MixCoreVoices<3>(dest, coreidx);
+            break;
+        case 4:
+            MixCoreVoices<4>(dest, coreidx);
+            break;
+
+            jNO_DEFAULT;
     }
 }
 
@@ -0,0 +1,207 @@
+/* SPU2-X, A plugin for Emulating the Sound Processing Unit of the Playstation 2
+ * Developed and maintained by the Pcsx2 Development Team.
+ *
+ * SPU2-X is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Found-
+ * ation, either version 3 of the License, or (at your option) any later version.
+ *
+ * SPU2-X is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SPU2-X.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// Last stage of the voice mixer: interpolation, ADSR envelope, voice volume and voice gates.
+// Unlike the rest of MixVoice (pitch modulation, sample fetching, IRQs) it only depends on
+// the voice's own state, so MixCoreVoices gathers that state for all the voices of a core
+// (VoiceLanes, one array per field) and mixes them together, four voices per instruction
+// with SSE4.1, eight with AVX2.  The SIMD versions are built in their own files with their
+// own target flags (MixerVoicesSSE41.cpp, MixerVoicesAVX2.cpp) and picked at runtime from
+// cpuid, so the default build uses them too.
+//
+// Kept free of the plugin globals so MixerBench.cpp can check and time it on its own.
+
+struct VoiceLanes
+{
+    static const uint Count = 24; // V_Core::NumVoices
+
+    // Last four decoded samples (PV1 is the newest) and the sample position.
+    __aligned32 s32 PV1[Count];
+    __aligned32 s32 PV2[Count];
+    __aligned32 s32 PV3[Count];
+    __aligned32 s32 PV4[Count];
+    __aligned32 s32 SP[Count];
+
+    // Noise voices aren't interpolated: Raw holds their value and IsRaw is -1.
+    __aligned32 s32 Raw[Count];
+    __aligned32 s32 IsRaw[Count];
+
+    // 0 for voices which are off.
+    __aligned32 s32 ADSR[Count];
+
+    __aligned32 s32 VolL[Count];
+    __aligned32 s32 VolR[Count];
+
+    // Voice gates, sign-extended to 0 or -1.
+    __aligned32 s32 DryL[Count];
+    __aligned32 s32 DryR[Count];
+    __aligned32 s32 WetL[Count];
+    __aligned32 s32 WetR[Count];
+};
+
+struct VoiceLaneSums
+{
+    s32 DryL, DryR, WetL, WetR;
+};
+
+/*
+   Tension: 65535 is high, 32768 is normal, 0 is low
+*/
+template <s32 i_tension>
+__forceinline static s32 HermiteInterpolate(
+    s32 y0, // 16.0
+    s32 y1, // 16.0
+    s32 y2, // 16.0
+    s32 y3, // 16.0
+    s32 mu  //  0.12
+    )
+{
+    s32 m00 = ((y1 - y0) * i_tension) >> 16; // 16.0
+    s32 m01 = ((y2 - y1) * i_tension) >> 16; // 16.0
+    s32 m0 = m00 + m01;
+
+    s32 m10 = ((y2 - y1) * i_tension) >> 16; // 16.0
+    s32 m11 = ((y3 - y2) * i_tension) >> 16; // 16.0
+    s32 m1 = m10 + m11;
+
+    s32 val = ((2 * y1 + m0 + m1 - 2 * y2) * mu) >> 12;       // 16.0
+    val = ((val - 3 * y1 - 2 * m0 - m1 + 3 * y2) * mu) >> 12; // 16.0
+    val = ((val + m0) * mu) >> 11;                            // 16.0
+
+    return (val + (y1 << 1));
+}
+
+__forceinline static s32 CatmullRomInterpolate(
+    s32 y0, // 16.0
+    s32 y1, // 16.0
+    s32 y2, // 16.0
+    s32 y3, // 16.0
+    s32 mu  //  0.12
+    )
+{
+    //q(t) = 0.5 *(    	(2 * P1) +
+    //	(-P0 + P2) * t +
+    //	(2*P0 - 5*P1 + 4*P2 - P3) * t2 +
+    //	(-P0 + 3*P1- 3*P2 + P3) * t3)
+
+    s32 a3 = (-y0 + 3 * y1 - 3 * y2 + y3);
+    s32 a2 = (2 * y0 - 5 * y1 + 4 * y2 - y3);
+    s32 a1 = (-y0 + y2);
+    s32 a0 = (2 * y1);
+
+    s32 val = ((a3)*mu) >> 12;
+    val = ((a2 + val) * mu) >> 12;
+    val = ((a1 + val) * mu) >> 12;
+
+    return (a0 + val);
+}
+
+__forceinline static s32 CubicInterpolate(
+    s32 y0, // 16.0
+    s32 y1, // 16.0
+    s32 y2, // 16.0
+    s32 y3, // 16.0
+    s32 mu  //  0.12
+    )
+{
+    const s32 a0 = y3 - y2 - y0 + y1;
+    const s32 a1 = y0 - y1 - a0;
+    const s32 a2 = y2 - y0;
+
+    s32 val = ((a0)*mu) >> 12;
+    val = ((val + a1) * mu) >> 12;
+    val = ((val + a2) * mu) >> 11;
+
+    return (val + (y1 << 1));
+}
+
+// Returns a 16 bit result: the voice's sample at SP (-4095 to 0 after GetVoiceValues).
+template <int InterpType>
+__forceinline static s32 InterpolateVoice(s32 PV1, s32 PV2, s32 PV3, s32 PV4, s32 SP)
+{
+    const s32 mu = SP + 4096;
+
+    switch (InterpType) {
+        case 0:
+            return PV1 << 1;
+        case 1:
+            return (PV1 << 1) - (((PV2 - PV1) * SP) >> 11);
+
+        case 2:
+            return CubicInterpolate(PV4, PV3, PV2, PV1, mu);
+        case 3:
+            return HermiteInterpolate<16384>(PV4, PV3, PV2, PV1, mu);
+        case 4:
+            return CatmullRomInterpolate(PV4, PV3, PV2, PV1, mu);
+    }
+
+    return 0; // technically unreachable!
+}
+
+__forceinline static s32 MulShr32Lane(s32 srcval, s32 mulval)
+{
+    return (s64)srcval * mulval >> 32;
+}
+
+// Plain version, one voice at a time.  Also the reference of MixerBench.
+template <int InterpType>
+static __forceinline void MixVoiceLanes_Scalar(const VoiceLanes &lanes, VoiceLaneSums &sums)
+{
+    for (uint i = 0; i < VoiceLanes::Count; i++) {
+        s32 Value = lanes.IsRaw[i] ? lanes.Raw[i] : InterpolateVoice<InterpType>(lanes.PV1[i], lanes.PV2[i], lanes.PV3[i], lanes.PV4[i], lanes.SP[i]);
+
+        Value = MulShr32Lane(Value, lanes.ADSR[i]);
+
+        const s32 Left = MulShr32Lane(Value << 1, lanes.VolL[i]);
+        const s32 Right = MulShr32Lane(Value << 1, lanes.VolR[i]);
+
+        sums.DryL += Left & lanes.DryL[i];
+        sums.DryR += Right & lanes.DryR[i];
+        sums.WetL += Left & lanes.WetL[i];
+        sums.WetR += Right & lanes.WetR[i];
+    }
+}
+
+// One function per InterpType, MixVoiceLanes_Scalar or the SIMD versions of it.
+typedef void MixVoiceLanesFn(const VoiceLanes &lanes, VoiceLaneSums &sums);
+
+extern MixVoiceLanesFn *const MixVoiceLanes_SSE41[5];
+extern MixVoiceLanesFn *const MixVoiceLanes_AVX2[5];
+
+// The plugin doesn't run the x86caps detection, so check cpuid here.
+static __forceinline bool MixVoiceLanesHasSSE41()
+{
+    int info[4];
+    cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+}
+
+static __forceinline bool MixVoiceLanesHasAVX2()
+{
+    int info[4];
+    cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    // AVX, and the OS saves the ymm registers (OSXSAVE, XCR0)
+    cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6)
+        return false;
+
+    cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+}
@@ -0,0 +1,181 @@
+/* SPU2-X, A plugin for Emulating the Sound Processing Unit of the Playstation 2
+ * Developed and maintained by the Pcsx2 Development Team.
+ *
+ * SPU2-X is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Found-
+ * ation, either version 3 of the License, or (at your option) any later version.
+ *
+ * SPU2-X is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SPU2-X.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+// SIMD version of MixVoiceLanes_Scalar, only included by MixerVoicesSSE41.cpp and
+// MixerVoicesAVX2.cpp: the intrinsics need the target flags of those files.  The AVX2 one
+// defines SPU2X_MIX_AVX2 first to get the 256 bits vectors.
+
+#include <immintrin.h>
+
+// The SIMD version is written once for both vector widths, on top of these.
+namespace MixLanes
+{
+static __forceinline __m128i Zero(__m128i) { return _mm_setzero_si128(); }
+static __forceinline __m128i Set(__m128i, s32 x) { return _mm_set1_epi32(x); }
+static __forceinline __m128i Add(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+static __forceinline __m128i Sub(__m128i a, __m128i b) { return _mm_sub_epi32(a, b); }
+static __forceinline __m128i Mul(__m128i a, __m128i b) { return _mm_mullo_epi32(a, b); }
+static __forceinline __m128i And(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+static __forceinline __m128i Select(__m128i a, __m128i b, __m128i mask) { return _mm_blendv_epi8(a, b, mask); }
+template <int i> static __forceinline __m128i Sll(__m128i a) { return _mm_slli_epi32(a, i); }
+template <int i> static __forceinline __m128i Sra(__m128i a) { return _mm_srai_epi32(a, i); }
+
+// (s64)a * b >> 32 on each lane
+static __forceinline __m128i MulShr32(__m128i a, __m128i b)
+{
+    const __m128i even = _mm_srli_epi64(_mm_mul_epi32(a, b), 32);
+    const __m128i odd = _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+
+    return _mm_blend_epi16(even, odd, 0xcc);
+}
+
+static __forceinline __m128i Narrow(__m128i a) { return a; }
+
+#ifdef SPU2X_MIX_AVX2
+
+static __forceinline __m256i Zero(__m256i) { return _mm256_setzero_si256(); }
+static __forceinline __m256i Set(__m256i, s32 x) { return _mm256_set1_epi32(x); }
+static __forceinline __m256i Add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+static __forceinline __m256i Sub(__m256i a, __m256i b) { return _mm256_sub_epi32(a, b); }
+static __forceinline __m256i Mul(__m256i a, __m256i b) { return _mm256_mullo_epi32(a, b); }
+static __forceinline __m256i And(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+static __forceinline __m256i Select(__m256i a, __m256i b, __m256i mask) { return _mm256_blendv_epi8(a, b, mask); }
+template <int i> static __forceinline __m256i Sll(__m256i a) { return _mm256_slli_epi32(a, i); }
+template <int i> static __forceinline __m256i Sra(__m256i a) { return _mm256_srai_epi32(a, i); }
+
+static __forceinline __m256i MulShr32(__m256i a, __m256i b)
+{
+    const __m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), 32);
+    const __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+
+    return _mm256_blend_epi32(even, odd, 0xaa);
+}
+
+static __forceinline __m128i Narrow(__m256i a) { return _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1)); }
+
+typedef __m256i Vector; // 24 voices, 3 iterations
+static __forceinline Vector Load(const s32 *p) { return _mm256_load_si256((const __m256i *)p); }
+#else
+typedef __m128i Vector; // 24 voices, 6 iterations
+static __forceinline Vector Load(const s32 *p) { return _mm_load_si128((const __m128i *)p); }
+#endif
+
+// The same arithmetic as InterpolateVoice, wrapping included.
+template <int InterpType, typename V>
+static __forceinline V Interpolate(V PV1, V PV2, V PV3, V PV4, V SP)
+{
+    const V mu = Add(SP, Set(SP, 4096));
+    const V y0 = PV4, y1 = PV3, y2 = PV2, y3 = PV1;
+
+    switch (InterpType) {
+        case 0:
+            return Sll<1>(PV1);
+
+        case 1:
+            return Sub(Sll<1>(PV1), Sra<11>(Mul(Sub(PV2, PV1), SP)));
+
+        case 2: {
+            const V a0 = Sub(Add(Sub(y3, y2), y1), y0);
+            const V a1 = Sub(Sub(y0, y1), a0);
+            const V a2 = Sub(y2, y0);
+
+            V val = Sra<12>(Mul(a0, mu));
+            val = Sra<12>(Mul(Add(val, a1), mu));
+            val = Sra<11>(Mul(Add(val, a2), mu));
+
+            return Add(val, Sll<1>(y1));
+        }
+
+        case 3: {
+            // tension 16384: (x * 16384) >> 16
+            const V d10 = Sra<16>(Sll<14>(Sub(y1, y0)));
+            const V d21 = Sra<16>(Sll<14>(Sub(y2, y1)));
+            const V d32 = Sra<16>(Sll<14>(Sub(y3, y2)));
+            const V m0 = Add(d10, d21);
+            const V m1 = Add(d21, d32);
+            const V y1x2 = Sll<1>(y1);
+            const V y2x2 = Sll<1>(y2);
+
+            V val = Sra<12>(Mul(Sub(Add(Add(y1x2, m0), m1), y2x2), mu));
+            val = Add(Sub(Sub(Sub(val, Add(y1x2, y1)), Sll<1>(m0)), m1), Add(y2x2, y2)); // val - 3 * y1 - 2 * m0 - m1 + 3 * y2
+            val = Sra<12>(Mul(val, mu));
+            val = Sra<11>(Mul(Add(val, m0), mu));
+
+            return Add(val, y1x2);
+        }
+
+        case 4: {
+            const V a3 = Add(Sub(Sub(Add(Sll<1>(y1), y1), y0), Add(Sll<1>(y2), y2)), y3);    // -y0 + 3 * y1 - 3 * y2 + y3
+            const V a2 = Sub(Sub(Add(Sll<1>(y0), Sll<2>(y2)), Add(Sll<2>(y1), y1)), y3);     // 2 * y0 - 5 * y1 + 4 * y2 - y3
+            const V a1 = Sub(y2, y0);
+            const V a0 = Sll<1>(y1);
+
+            V val = Sra<12>(Mul(a3, mu));
+            val = Sra<12>(Mul(Add(a2, val), mu));
+            val = Sra<12>(Mul(Add(a1, val), mu));
+
+            return Add(a0, val);
+        }
+    }
+
+    return Zero(SP);
+}
+}
+
+template <int InterpType>
+static void MixVoiceLanes_SIMD(const VoiceLanes &lanes, VoiceLaneSums &sums)
+{
+    using namespace MixLanes;
+
+    const uint Width = sizeof(Vector) / sizeof(s32);
+    static_assert(VoiceLanes::Count % Width == 0, "VoiceLanes::Count must be a multiple of the vector width");
+
+    Vector DryL = Zero(Vector()), DryR = DryL, WetL = DryL, WetR = DryL;
+
+    for (uint i = 0; i < VoiceLanes::Count; i += Width) {
+        Vector Value = Interpolate<InterpType>(Load(&lanes.PV1[i]), Load(&lanes.PV2[i]), Load(&lanes.PV3[i]), Load(&lanes.PV4[i]), Load(&lanes.SP[i]));
+
+        Value = Select(Value, Load(&lanes.Raw[i]), Load(&lanes.IsRaw[i]));
+        Value = Sll<1>(MulShr32(Value, Load(&lanes.ADSR[i])));
+
+        const Vector Left = MulShr32(Value, Load(&lanes.VolL[i]));
+        const Vector Right = MulShr32(Value, Load(&lanes.VolR[i]));
+
+        DryL = Add(DryL, And(Left, Load(&lanes.DryL[i])));
+        DryR = Add(DryR, And(Right, Load(&lanes.DryR[i])));
+        WetL = Add(WetL, And(Left, Load(&lanes.WetL[i])));
+        WetR = Add(WetR, And(Right, Load(&lanes.WetR[i])));
+    }
+
+    // Transpose so each lane holds one of the sums, then add the four rows up
+    const __m128i t0 = _mm_unpacklo_epi32(Narrow(DryL), Narrow(DryR));
+    const __m128i t1 = _mm_unpackhi_epi32(Narrow(DryL), Narrow(DryR));
+    const __m128i t2 = _mm_unpacklo_epi32(Narrow(WetL), Narrow(WetR));
+    const __m128i t3 = _mm_unpackhi_epi32(Narrow(WetL), Narrow(WetR));
+
+    const __m128i total = _mm_add_epi32(
+        _mm_add_epi32(_mm_unpacklo_epi64(t0, t2), _mm_unpackhi_epi64(t0, t2)),
+        _mm_add_epi32(_mm_unpacklo_epi64(t1, t3), _mm_unpackhi_epi64(t1, t3)));
+
+    __aligned16 s32 result[4];
+    _mm_store_si128((__m128i *)result, total);
+
+    sums.DryL += result[0];
+    sums.DryR += result[1];
+    sums.WetL += result[2];
+    sums.WetR += result[3];
+}
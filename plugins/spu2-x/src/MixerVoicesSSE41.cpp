@@ -0,0 +1,33 @@
+/* SPU2-X, A plugin for Emulating the Sound Processing Unit of the Playstation 2
+ * Developed and maintained by the Pcsx2 Development Team.
+ *
+ * SPU2-X is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU Lesser General Public License as published by the Free Software Found-
+ * ation, either version 3 of the License, or (at your option) any later version.
+ *
+ * SPU2-X is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with SPU2-X.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Built with -msse4.1 (Visual Studio: see the project settings of this file).  Nothing but
+// the mixer kernel goes in here, any inline function of the plugin headers would be compiled
+// for that instruction set too.
+
+#include "Pcsx2Defs.h"
+#include "Pcsx2Types.h"
+
+#include "MixerVoices.h"
+#include "MixerVoicesSIMD.h"
+
+MixVoiceLanesFn *const MixVoiceLanes_SSE41[5] =
+{
+    MixVoiceLanes_SIMD<0>,
+    MixVoiceLanes_SIMD<1>,
+    MixVoiceLanes_SIMD<2>,
+    MixVoiceLanes_SIMD<3>,
+    MixVoiceLanes_SIMD<4>,
+};
@@ -17,6 +17,10 @@
 
 #include "Global.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 StereoOut32 StereoOut32::Empty(0, 0);
 
@@ -398,12 +402,18 @@ void SndBuffer::Init()
     soundtouchInit(); // initializes the timestretching
 
     // initialize module
-    if (mods[OutputModule]->Init() == -1)
+    if (mods[OutputModule]->Init() == -1) {
         _InitFail();
+        return;
+    }
+
+    _StartOutputThread();
 }
 
 void SndBuffer::Cleanup()
 {
+    _StopOutputThread();
+
     mods[OutputModule]->Close();
 
     soundtouchCleanup();
@@ -420,11 +430,137 @@ int SndBuffer::ssFreeze = 0;
 
 void SndBuffer::ClearContents()
 {
+    // The time stretcher belongs to the output thread while it runs
+    _WaitOutputThread();
+
     SndBuffer::soundtouchClearContents();
     SndBuffer::ssFreeze = 256; //Delays sound output for about 1 second.
 }
 
+// --------------------------------------------------------------------------------------
+//  Output thread
+// --------------------------------------------------------------------------------------
+// Everything that happens to a sample once the cores mixed it (wave dumps, time stretching
+// and the copy into the output buffer) is invisible to the emulation, so with OutputThread
+// it runs on its own thread: Write only queues the samples a packet at a time.  Mixing the
+// voices, the reverb and the writes of the mix back to SPU2 RAM stay in TimeUpdate, so the
+// IRQ and DMA timings are the same as without the thread.
+
+static const int OutputQueueSize = 64; // packets (about 85 ms), must be a power of 2
+
+static StereoOut32 s_output_queue[OutputQueueSize][SndOutPacketSize];
+static int s_output_progress = 0; // samples of the packet being filled by the emulation thread
+static std::atomic<int> s_output_rpos(0);
+static std::atomic<int> s_output_wpos(0);
+
+static std::thread s_output_thread;
+static std::mutex s_output_lock;
+static std::condition_variable s_output_queued; // signaled by the emulation thread
+static std::condition_variable s_output_done;   // signaled by the output thread
+static bool s_output_exit = false;
+
+void SndBuffer::_StartOutputThread()
+{
+    // Null output has nothing expensive to offload, and the Winamp DSP plugins expect to be
+    // called from the thread which loaded them.
+    if (!OutputThread || mods[OutputModule] == &NullOut)
+        return;
+#ifndef __POSIX__
+    if (dspPluginEnabled)
+        return;
+#endif
+
+    s_output_progress = 0;
+    s_output_rpos = 0;
+    s_output_wpos = 0;
+    s_output_exit = false;
+
+    s_output_thread = std::thread(&SndBuffer::_OutputThread);
+}
+
+void SndBuffer::_StopOutputThread()
+{
+    if (!s_output_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(s_output_lock);
+        s_output_exit = true;
+    }
+    s_output_queued.notify_one();
+
+    s_output_thread.join();
+}
+
+// Waits until the output thread has written all the queued packets.
+void SndBuffer::_WaitOutputThread()
+{
+    if (!s_output_thread.joinable())
+        return;
+
+    std::unique_lock<std::mutex> lock(s_output_lock);
+    s_output_done.wait(lock, [] { return s_output_rpos.load(std::memory_order_acquire) == s_output_wpos.load(std::memory_order_relaxed); });
+
+    // A partial packet would be queued after the wait, drop it like the stretcher's contents.
+    s_output_progress = 0;
+}
+
+void SndBuffer::_OutputThread()
+{
+    std::unique_lock<std::mutex> lock(s_output_lock);
+
+    while (true) {
+        s_output_queued.wait(lock, [] { return s_output_exit || s_output_rpos.load(std::memory_order_relaxed) != s_output_wpos.load(std::memory_order_acquire); });
+
+        if (s_output_exit)
+            break;
+
+        lock.unlock();
+
+        const int wpos = s_output_wpos.load(std::memory_order_acquire);
+        int rpos = s_output_rpos.load(std::memory_order_relaxed);
+
+        for (; rpos != wpos; rpos = (rpos + 1) & (OutputQueueSize - 1)) {
+            for (int i = 0; i < SndOutPacketSize; ++i)
+                _WriteSample(s_output_queue[rpos][i]);
+
+            s_output_rpos.store((rpos + 1) & (OutputQueueSize - 1), std::memory_order_release);
+        }
+
+        lock.lock();
+        s_output_done.notify_one();
+    }
+}
+
 void SndBuffer::Write(const StereoOut32 &Sample)
+{
+    if (!s_output_thread.joinable()) {
+        _WriteSample(Sample);
+        return;
+    }
+
+    const int wpos = s_output_wpos.load(std::memory_order_relaxed);
+
+    s_output_queue[wpos][s_output_progress++] = Sample;
+
+    if (s_output_progress < SndOutPacketSize)
+        return;
+    s_output_progress = 0;
+
+    const int next = (wpos + 1) & (OutputQueueSize - 1);
+
+    std::unique_lock<std::mutex> lock(s_output_lock);
+
+    // The output thread fell a whole queue behind (the host is overloaded): wait for it rather
+    // than dropping audio, the synchronous path would have taken that time anyway.
+    if (next == s_output_rpos.load(std::memory_order_acquire))
+        s_output_done.wait(lock, [next] { return next != s_output_rpos.load(std::memory_order_acquire); });
+
+    s_output_wpos.store(next, std::memory_order_release);
+    s_output_queued.notify_one();
+}
+
+void SndBuffer::_WriteSample(const StereoOut32 &Sample)
 {
     // Log final output to wavefile.
     WaveDump::WriteCore(1, CoreSrc_External, Sample.DownSample());
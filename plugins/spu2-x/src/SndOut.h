@@ -605,6 +605,12 @@ private:
     static void UpdateTempoChangeSoundTouch2();
 
     static void _WriteSamples(StereoOut32 *bData, int nSamples);
+    static void _WriteSample(const StereoOut32 &Sample);
+
+    static void _StartOutputThread();
+    static void _StopOutputThread();
+    static void _WaitOutputThread();
+    static void _OutputThread();
 
     static void _WriteSamples_Safe(StereoOut32 *bData, int nSamples);
     static void _ReadSamples_Safe(StereoOut32 *bData, int nSamples);
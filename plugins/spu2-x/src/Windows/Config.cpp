@@ -66,6 +66,7 @@ bool postprocess_filter_dealias = false;
 // OUTPUT
 int SndOutLatencyMS = 100;
 int SynchMode = 0; // Time Stretch, Async or Disabled
+bool OutputThread = false;
 
 u32 OutputModule = 0;
 
@@ -113,6 +114,7 @@ void ReadSettings()
     VolumeAdjustLFE = powf(10, VolumeAdjustLFEdb / 10);
 
     SynchMode = CfgReadInt(L"OUTPUT", L"Synch_Mode", 0);
+    OutputThread = CfgReadBool(L"OUTPUT", L"Output_Thread", false);
     numSpeakers = CfgReadInt(L"OUTPUT", L"SpeakerConfiguration", 0);
     dplLevel = CfgReadInt(L"OUTPUT", L"DplDecodingLevel", 0);
     SndOutLatencyMS = CfgReadInt(L"OUTPUT", L"Latency", 100);
@@ -186,6 +188,7 @@ void WriteSettings()
     CfgWriteStr(L"OUTPUT", L"Output_Module", mods[OutputModule]->GetIdent());
     CfgWriteInt(L"OUTPUT", L"Latency", SndOutLatencyMS);
     CfgWriteInt(L"OUTPUT", L"Synch_Mode", SynchMode);
+    CfgWriteBool(L"OUTPUT", L"Output_Thread", OutputThread);
     CfgWriteInt(L"OUTPUT", L"SpeakerConfiguration", numSpeakers);
     CfgWriteInt(L"OUTPUT", L"DplDecodingLevel", dplLevel);
     CfgWriteInt(L"DEBUG", L"DelayCycles", delayCycles);
@@ -288,6 +291,7 @@ BOOL CALLBACK ConfigProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
             SET_CHECK(IDC_DEALIASFILTER, postprocess_filter_dealias);
             SET_CHECK(IDC_DEBUG_ENABLE, DebugEnabled);
             SET_CHECK(IDC_DSP_ENABLE, dspPluginEnabled);
+            SET_CHECK(IDC_OUTPUT_THREAD, OutputThread);
         } break;
 
         case WM_COMMAND:
@@ -361,6 +365,7 @@ BOOL CALLBACK ConfigProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
                     HANDLE_CHECK(IDC_EFFECTS_DISABLE, EffectsDisabled);
                     HANDLE_CHECK(IDC_DEALIASFILTER, postprocess_filter_dealias);
                     HANDLE_CHECK(IDC_DSP_ENABLE, dspPluginEnabled);
+                    HANDLE_CHECK(IDC_OUTPUT_THREAD, OutputThread);
                     HANDLE_CHECKNB(IDC_DEBUG_ENABLE, DebugEnabled);
                     DebugConfig::EnableControls(hWnd);
                     EnableWindow(GetDlgItem(hWnd, IDC_OPEN_CONFIG_DEBUG), DebugEnabled);
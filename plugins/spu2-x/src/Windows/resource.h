@@ -61,6 +61,7 @@
 #define IDC_PA_HOSTAPI                  1071
 #define IDC_LATENCY                     1072
 #define IDC_EXCLUSIVE                   1073
+#define IDC_OUTPUT_THREAD               1074
 
 // Next default values for new objects
 // 
@@ -68,7 +69,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        120
 #define _APS_NEXT_COMMAND_VALUE         40001
-#define _APS_NEXT_CONTROL_VALUE         1074
+#define _APS_NEXT_CONTROL_VALUE         1075
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif